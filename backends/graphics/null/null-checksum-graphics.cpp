@@ -0,0 +1,173 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "backends/graphics/null/null-checksum-graphics.h"
+
+#include "common/file.h"
+#include "common/rect.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+// 32 bits FNV-1a, which can be computed in several passes.
+static uint32 hashData(const byte *data, uint32 size, uint32 hash) {
+	for (uint32 i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 16777619;
+	}
+	return hash;
+}
+
+uint32 NullChecksumGraphicsManager::hashSurface(const Graphics::Surface &surface, uint32 hash) {
+	for (int y = 0; y < surface.h; y++)
+		hash = hashData((const byte *)surface.getBasePtr(0, y), surface.w * surface.format.bytesPerPixel, hash);
+	return hash;
+}
+
+NullChecksumGraphicsManager::NullChecksumGraphicsManager(const Common::String &fileName) :
+		_stream(nullptr), _frameCount(0), _lastFrameTime(0) {
+	memset(_palette, 0, sizeof(_palette));
+
+	Common::DumpFile *file = new Common::DumpFile();
+	if (file->open(fileName, true)) {
+		_stream = file;
+		writeHeader();
+	} else {
+		warning("Could not open '%s' to write the frame checksums", fileName.c_str());
+		delete file;
+	}
+}
+
+NullChecksumGraphicsManager::NullChecksumGraphicsManager(Common::WriteStream *stream) :
+		_stream(stream), _frameCount(0), _lastFrameTime(0) {
+	memset(_palette, 0, sizeof(_palette));
+	writeHeader();
+}
+
+NullChecksumGraphicsManager::~NullChecksumGraphicsManager() {
+	delete _stream;
+	_screen.free();
+	_overlay.free();
+}
+
+void NullChecksumGraphicsManager::initSize(uint width, uint height, const Graphics::PixelFormat *format) {
+	NullGraphicsManager::initSize(width, height, format);
+
+	_screen.free();
+	_screen.create(width, height, getScreenFormat());
+	_overlay.free();
+	_overlay.create(getOverlayWidth(), getOverlayHeight(), getOverlayFormat());
+}
+
+void NullChecksumGraphicsManager::setPalette(const byte *colors, uint start, uint num) {
+	assert(start + num <= 256);
+	memcpy(_palette + start * 3, colors, num * 3);
+}
+
+void NullChecksumGraphicsManager::grabPalette(byte *colors, uint start, uint num) const {
+	assert(start + num <= 256);
+	memcpy(colors, _palette + start * 3, num * 3);
+}
+
+void NullChecksumGraphicsManager::copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+	copyRectToSurface(_screen, buf, pitch, x, y, w, h);
+}
+
+Graphics::Surface *NullChecksumGraphicsManager::lockScreen() {
+	return &_screen;
+}
+
+void NullChecksumGraphicsManager::fillScreen(uint32 col) {
+	_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+}
+
+void NullChecksumGraphicsManager::updateScreen() {
+	uint32 hash = kChecksumBasis;
+	if (isOverlayVisible()) {
+		hash = hashSurface(_overlay, hash);
+	} else {
+		hash = hashSurface(_screen, hash);
+		// The same pixels look different with another palette.
+		if (_screen.format.bytesPerPixel == 1)
+			hash = hashData(_palette, sizeof(_palette), hash);
+	}
+
+	// Timing queries of the backend itself must not end up in event
+	// recordings, or playing them back would get out of sync.
+	uint32 time = g_system->getMillis(true);
+	uint32 elapsed = _frameCount ? time - _lastFrameTime : 0;
+	_lastFrameTime = time;
+
+	// The backend may quit by exiting, so the lines are not kept buffered.
+	if (_stream) {
+		_stream->writeString(Common::String::format("%u,%u,%08x\n", _frameCount, elapsed, hash));
+		_stream->flush();
+	}
+	_frameCount++;
+}
+
+void NullChecksumGraphicsManager::writeHeader() {
+	_stream->writeString("frame,milliseconds,checksum\n");
+}
+
+void NullChecksumGraphicsManager::clearOverlay() {
+	_overlay.fillRect(Common::Rect(_overlay.w, _overlay.h), 0);
+}
+
+void NullChecksumGraphicsManager::grabOverlay(Graphics::Surface &surface) const {
+	assert(surface.w >= _overlay.w);
+	assert(surface.h >= _overlay.h);
+	assert(surface.format.bytesPerPixel == _overlay.format.bytesPerPixel);
+
+	for (int y = 0; y < _overlay.h; y++)
+		memcpy(surface.getBasePtr(0, y), _overlay.getBasePtr(0, y), _overlay.w * _overlay.format.bytesPerPixel);
+}
+
+void NullChecksumGraphicsManager::copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {
+	copyRectToSurface(_overlay, buf, pitch, x, y, w, h);
+}
+
+void NullChecksumGraphicsManager::copyRectToSurface(Graphics::Surface &surface, const void *buf, int pitch, int x, int y, int w, int h) {
+	const byte *src = (const byte *)buf;
+
+	// Clip the coordinates
+	if (x < 0) {
+		w += x;
+		src -= x * surface.format.bytesPerPixel;
+		x = 0;
+	}
+
+	if (y < 0) {
+		h += y;
+		src -= y * pitch;
+		y = 0;
+	}
+
+	if (w > surface.w - x)
+		w = surface.w - x;
+
+	if (h > surface.h - y)
+		h = surface.h - y;
+
+	if (w <= 0 || h <= 0)
+		return;
+
+	surface.copyRectToSurface(src, pitch, x, y, w, h);
+}
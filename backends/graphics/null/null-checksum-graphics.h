@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_NULL_CHECKSUM_H
+#define BACKENDS_GRAPHICS_NULL_CHECKSUM_H
+
+#include "backends/graphics/null/null-graphics.h"
+
+#include "common/stream.h"
+#include "graphics/surface.h"
+
+/**
+ * Graphics manager for headless runs that keeps the game screen and the
+ * overlay in memory like a real backend would. Every updateScreen() call
+ * adds a line to a CSV file with the number of the frame, the milliseconds
+ * elapsed since the previous frame and a checksum of the displayed pixels,
+ * so that both rendering changes and performance regressions can be found
+ * by comparing the files of two runs.
+ *
+ * The mouse cursor and the shake offset are not part of the checksum.
+ */
+class NullChecksumGraphicsManager : public NullGraphicsManager {
+public:
+	NullChecksumGraphicsManager(const Common::String &fileName);
+	/** Writes the lines to the stream, which is taken ownership of. */
+	NullChecksumGraphicsManager(Common::WriteStream *stream);
+	virtual ~NullChecksumGraphicsManager();
+
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) override;
+
+	void setPalette(const byte *colors, uint start, uint num) override;
+	void grabPalette(byte *colors, uint start, uint num) const override;
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override;
+	Graphics::Surface *lockScreen() override;
+	void unlockScreen() override {}
+	void fillScreen(uint32 col) override;
+	void updateScreen() override;
+
+	void clearOverlay() override;
+	void grabOverlay(Graphics::Surface &surface) const override;
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) override;
+
+	/** Initial value of the checksums. */
+	static const uint32 kChecksumBasis = 2166136261u;
+
+	/**
+	 * Adds the visible pixels of a surface to a checksum, the way those of
+	 * the screen are, so that other tools can checksum frames alike.
+	 */
+	static uint32 hashSurface(const Graphics::Surface &surface, uint32 hash = kChecksumBasis);
+
+private:
+	Graphics::Surface _screen;
+	Graphics::Surface _overlay;
+	byte _palette[256 * 3];
+
+	Common::WriteStream *_stream;
+	uint32 _frameCount;
+	uint32 _lastFrameTime;
+
+	void writeHeader();
+	void copyRectToSurface(Graphics::Surface &surface, const void *buf, int pitch, int x, int y, int w, int h);
+};
+
+#endif
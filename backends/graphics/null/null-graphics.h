@@ -26,6 +26,7 @@
 
 class NullGraphicsManager : public GraphicsManager {
 public:
+	NullGraphicsManager() : _width(0), _height(0), _overlayVisible(false) {}
 	virtual ~NullGraphicsManager() {}
 
 	bool hasFeature(OSystem::Feature f) const override { return false; }
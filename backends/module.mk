@@ -336,6 +336,7 @@ endif
 
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
+	graphics/null/null-checksum-graphics.o \
 	mixer/null/null-mixer.o
 endif
 
@@ -49,14 +49,16 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mixer/null/null-mixer.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
-#include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
+#include "backends/graphics/null/null-checksum-graphics.h"
+#include "common/config-manager.h"
 #include "gui/debugger.h"
 #endif
 
@@ -95,6 +97,10 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	void initTestMixer();
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -117,11 +123,26 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// The backend is not initialized in tests, but the screen format is
+	// still queried, e.g. by the video decoders
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+void OSystem_NULL::initTestMixer() {
+	// The mixer needs g_system for its mutexes, so this is only called once
+	// the backend is installed
+	_mixerManager = new NullMixerManager();
+	_mixerManager->init();
+}
+#endif
+
 #if defined(POSIX) && !defined(NULL_DRIVER_USE_FOR_TEST)
 static volatile bool intReceived = false;
 
@@ -148,7 +169,10 @@ void OSystem_NULL::initBackend() {
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
-	_graphicsManager = new NullGraphicsManager();
+	if (ConfMan.hasKey("frame_checksums"))
+		_graphicsManager = new NullChecksumGraphicsManager(ConfMan.get("frame_checksums"));
+	else
+		_graphicsManager = new NullGraphicsManager();
 	_mixerManager = new NullMixerManager();
 	// Setup and start mixer
 	_mixerManager->init();
@@ -185,6 +185,10 @@ static const char HELP_STRING[] =
 	"  --screenshot-period=NUM  When recording, trigger a screenshot every NUM milliseconds\n"
 	"                           (default: 60000)\n"
 	"  --list-records           Display a list of recordings for the target specified\n"
+#endif
+#ifdef USE_NULL_DRIVER
+	"  --frame-checksums=FILE   Write the checksum and duration of every frame to a CSV\n"
+	"                           file\n"
 #endif
 	"\n"
 #if defined(ENABLE_SKY) || defined(ENABLE_QUEEN)
@@ -693,6 +697,11 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			END_OPTION
 #endif
 
+#ifdef USE_NULL_DRIVER
+			DO_LONG_OPTION("frame-checksums")
+			END_OPTION
+#endif
+
 			DO_LONG_OPTION("opl-driver")
 			END_OPTION
 
@@ -381,7 +381,7 @@ public:
 			}
 		}
 
-		uint16 val = READ_LE_UINT16(_ptr);
+		uint16 val = READ_BE_UINT16(_ptr);
 
 		_pos += 2;
 		_ptr += 2;
@@ -29,6 +29,7 @@
 #include "common/fft.h"
 #include "common/util.h"
 #include "common/textconsole.h"
+#include "common/simd.h"
 
 namespace Common {
 
@@ -54,12 +55,40 @@ FFT::FFT(int bits, int inverse) : _bits(bits), _inverse(inverse) {
 		}
 		else
 			_cosTables[i] = nullptr;
+
+		_passTables[i] = nullptr;
 	}
+
+#ifdef SCUMMVM_SIMD
+	// Passes are only done for 32 points and up, see fft()
+	for (int i = 1; i < ARRAYSIZE(_cosTables); i++) {
+		if (!_cosTables[i])
+			continue;
+
+		const float *cosTable = _cosTables[i]->getTable();
+		const int o1 = 1 << (i + 2);
+
+		float *wre = _passTables[i] = new float[4 * o1];
+		float *wim = wre + 2 * o1;
+
+		// The first value of a pass is not rotated. The table would give a
+		// tiny sine instead of zero there.
+		wre[0] = wre[1] = 1.0f;
+		wim[0] = wim[1] = 0.0f;
+
+		for (int k = 1; k < o1; k++) {
+			wre[2 * k] = wre[2 * k + 1] = cosTable[k];
+			wim[2 * k] = cosTable[o1 - k];
+			wim[2 * k + 1] = -cosTable[o1 - k];
+		}
+	}
+#endif
 }
 
 FFT::~FFT() {
 	for (int i = 0; i < ARRAYSIZE(_cosTables); i++) {
 		delete _cosTables[i];
+		delete[] _passTables[i];
 	}
 
 	delete[] _revTab;
@@ -175,10 +204,83 @@ static void name(Complex *z, const float *wre, unsigned int n) { \
 	} while(--n);\
 }
 
+#ifndef SCUMMVM_SIMD
 PASS(pass)
+#endif
 #undef BUTTERFLIES
 #define BUTTERFLIES BUTTERFLIES_BIG
+#ifndef SCUMMVM_SIMD
 PASS(pass_big)
+#endif
+
+#ifdef SCUMMVM_SIMD
+
+// The same pass, two values at a time, with the twiddle factors of
+// _passTables. Each quarter of z is read before it is written, so this also
+// takes care of the aliasing that pass_big avoids.
+
+#if defined(SCUMMVM_SIMD_SSE2)
+
+typedef __m128 FFTVector;
+
+static inline FFTVector fftLoad(const float *src) { return _mm_loadu_ps(src); }
+static inline void fftStore(float *dest, FFTVector v) { _mm_storeu_ps(dest, v); }
+static inline FFTVector fftAdd(FFTVector a, FFTVector b) { return _mm_add_ps(a, b); }
+static inline FFTVector fftSub(FFTVector a, FFTVector b) { return _mm_sub_ps(a, b); }
+static inline FFTVector fftMul(FFTVector a, FFTVector b) { return _mm_mul_ps(a, b); }
+static inline FFTVector fftSwap(FFTVector a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)); }
+static inline FFTVector fftNegateIm(FFTVector a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set_epi32(0x80000000, 0, 0x80000000, 0))); }
+
+#else
+
+typedef float32x4_t FFTVector;
+
+static inline FFTVector fftLoad(const float *src) { return vld1q_f32(src); }
+static inline void fftStore(float *dest, FFTVector v) { vst1q_f32(dest, v); }
+static inline FFTVector fftAdd(FFTVector a, FFTVector b) { return vaddq_f32(a, b); }
+static inline FFTVector fftSub(FFTVector a, FFTVector b) { return vsubq_f32(a, b); }
+static inline FFTVector fftMul(FFTVector a, FFTVector b) { return vmulq_f32(a, b); }
+static inline FFTVector fftSwap(FFTVector a) { return vrev64q_f32(a); }
+static inline FFTVector fftNegateIm(FFTVector a) {
+	static const uint32 signs[4] = { 0, 0x80000000, 0, 0x80000000 };
+	return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vld1q_u32(signs)));
+}
+
+#endif
+
+static void passVector(Complex *z, const float *twiddles, int o1) {
+	float *a0 = (float *)z;
+	float *a1 = a0 + 2 * o1;
+	float *a2 = a1 + 2 * o1;
+	float *a3 = a2 + 2 * o1;
+
+	const float *wre = twiddles;
+	const float *wim = twiddles + 2 * o1;
+
+	for (int i = 0; i < 2 * o1; i += 4) {
+		const FFTVector r0 = fftLoad(a0 + i);
+		const FFTVector r1 = fftLoad(a1 + i);
+		const FFTVector r2 = fftLoad(a2 + i);
+		const FFTVector r3 = fftLoad(a3 + i);
+		const FFTVector cosines = fftLoad(wre + i);
+		const FFTVector sines = fftLoad(wim + i);
+
+		// { t1, t2 } and { t5, t6 } of TRANSFORM
+		const FFTVector t12 = fftAdd(fftMul(r2, cosines), fftMul(fftSwap(r2), sines));
+		const FFTVector t56 = fftSub(fftMul(r3, cosines), fftMul(fftSwap(r3), sines));
+
+		// BUTTERFLIES: { t5, t6 } and the swapped { t4, t3 }
+		const FFTVector sum = fftAdd(t56, t12);
+		const FFTVector diff = fftSwap(fftNegateIm(fftSub(t56, t12)));
+
+		fftStore(a0 + i, fftAdd(r0, sum));
+		fftStore(a2 + i, fftSub(r0, sum));
+		fftStore(a1 + i, fftAdd(r1, diff));
+		fftStore(a3 + i, fftSub(r1, diff));
+	}
+}
+
+#endif
 
 void FFT::fft4(Complex *z) {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
@@ -244,10 +346,14 @@ void FFT::fft(int n, int logn, Complex *z) {
 		fft((n / 4), logn - 2, z + (n / 4) * 2);
 		fft((n / 4), logn - 2, z + (n / 4) * 3);
 		assert(_cosTables[logn - 4]);
+#ifdef SCUMMVM_SIMD
+		passVector(z, _passTables[logn - 4], n / 4);
+#else
 		if (n > 1024)
 			pass_big(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
 		else
 			pass(z, _cosTables[logn - 4]->getTable(), (n / 4) / 2);
+#endif
 	}
 }
 
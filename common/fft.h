@@ -82,6 +82,14 @@ private:
 
 	CosineTable *_cosTables[13];
 
+	/**
+	 * Twiddle factors of the passes, laid out for the vectorized pass:
+	 * the cosines duplicated for the real and imaginary part of each
+	 * value, followed by the sines with the sign of the imaginary part
+	 * flipped. Only allocated when the pass is vectorized.
+	 */
+	float *_passTables[13];
+
 	void fft4(Complex *z);
 	void fft8(Complex *z);
 	void fft16(Complex *z);
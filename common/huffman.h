@@ -25,7 +25,6 @@
 #define COMMON_HUFFMAN_H
 
 #include "common/array.h"
-#include "common/list.h"
 #include "common/types.h"
 
 namespace Common {
@@ -54,6 +53,9 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * Codes are looked up in tables indexed by the next bits of the stream.
+ * Codes longer than a table are continued in a secondary table, so that
+ * decoding a symbol only takes a few table lookups.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -72,29 +74,40 @@ public:
 	uint32 getSymbol(BITSTREAM &bits) const;
 
 private:
-	struct Symbol {
+	/** A code, with its bits in the order they appear in the bit stream, MSB first. */
+	struct Code {
 		uint32 code;
+		uint8  length;
 		uint32 symbol;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		Code(uint32 c, uint8 l, uint32 s) : code(c), length(l), symbol(s) {}
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
-
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	typedef Array<Code> CodeList;
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
+	/**
+	 * An entry of a lookup table. If subTableBits is 0, the entry holds
+	 * a symbol and the number of bits of its code within this table.
+	 * Otherwise, symbol is the offset of the secondary table which
+	 * continues the codes starting with the bits of this entry.
+	 */
+	struct TableEntry {
 		uint32 symbol;
 		uint8  length;
+		uint8  subTableBits;
 
-		PrefixEntry() : length(0xFF) {}
+		TableEntry() : symbol(0), length(0xFF), subTableBits(0) {}
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** Maximal number of bits looked up in a single table. */
+	static const uint8 _maxTableBits = 10;
+
+	/** All lookup tables, starting with the primary one. */
+	Array<TableEntry> _tables;
+	uint8 _prefixTableBits;
+
+	void buildTable(uint32 offset, uint8 tableBits, uint8 depth, const CodeList &codes);
+	void setEntry(uint32 offset, uint8 tableBits, uint32 index, uint32 symbol, uint8 length, uint8 subTableBits);
 };
 
 template <class BITSTREAM>
@@ -110,62 +123,100 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 
 	assert(maxLength <= 32);
 
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	CodeList codeList;
+	codeList.reserve(codeCount);
 
-	for (uint i = 0; i < codeCount; i++) {
+	for (uint32 i = 0; i < codeCount; i++) {
 		uint8 length = lengths[i];
 
+		// The codes of LSB first bit streams have their first bit in the LSB
+		uint32 code = codes[i];
+		if (!BITSTREAM::isMSB2LSB())
+			code = length ? REVERSEBITS(code) >> (32 - length) : 0;
+
 		// The symbol. If none was specified, assume it is identical to the code index.
-		uint32 symbol = symbols ? symbols[i] : i;
-
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
+		codeList.push_back(Code(code, length, symbols ? symbols[i] : i));
+	}
 
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
+	_prefixTableBits = CLIP<uint8>(maxLength, 1, _maxTableBits);
+	_tables.resize(1 << _prefixTableBits);
 
-			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
-			}
+	buildTable(0, _prefixTableBits, 0, codeList);
+}
+
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(uint32 offset, uint8 tableBits, uint8 depth, const CodeList &codes) {
+	CodeList longCodes;
+
+	for (uint32 i = 0; i < codes.size(); i++) {
+		const uint8 length = codes[i].length - depth;
+		const uint32 code = codes[i].code & (length >= 32 ? 0xFFFFFFFF : (1u << length) - 1);
+
+		if (length <= tableBits) {
+			// Short codes fill all the entries with an index starting with the code
+			const uint32 startIndex = code << (tableBits - length);
+			for (uint32 j = 0; j < (1u << (tableBits - length)); j++)
+				setEntry(offset, tableBits, startIndex + j, codes[i].symbol, length, 0);
 		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+			longCodes.push_back(codes[i]);
 		}
 	}
-}
 
-template <class BITSTREAM>
-uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+	// Long codes are grouped by the bits looked up in this table, and each
+	// group gets a secondary table for the bits following them
+	while (!longCodes.empty()) {
+		const uint32 mask = (1u << tableBits) - 1;
+		const uint32 prefix = (longCodes[0].code >> (longCodes[0].length - depth - tableBits)) & mask;
+
+		CodeList group, others;
+		uint8 maxLength = 0;
+		for (uint32 i = 0; i < longCodes.size(); i++) {
+			const uint8 length = longCodes[i].length - depth - tableBits;
+			if (((longCodes[i].code >> length) & mask) == prefix) {
+				group.push_back(longCodes[i]);
+				maxLength = MAX(maxLength, length);
+			} else {
+				others.push_back(longCodes[i]);
+			}
+		}
 
-	uint8 length = _prefixTable[code].length;
+		const uint8 subTableBits = MIN(maxLength, _maxTableBits);
+		const uint32 subTableOffset = _tables.size();
+		_tables.resize(subTableOffset + (1 << subTableBits));
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+		setEntry(offset, tableBits, prefix, subTableOffset, tableBits, subTableBits);
+		buildTable(subTableOffset, subTableBits, depth + tableBits, group);
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+		longCodes = others;
+	}
+}
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
-		}
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::setEntry(uint32 offset, uint8 tableBits, uint32 index, uint32 symbol, uint8 length, uint8 subTableBits) {
+	// The tables are indexed by the bits as they are peeked from the stream
+	if (!BITSTREAM::isMSB2LSB())
+		index = REVERSEBITS(index) >> (32 - tableBits);
+
+	TableEntry &entry = _tables[offset + index];
+	entry.symbol = symbol;
+	entry.length = length;
+	entry.subTableBits = subTableBits;
+}
+
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
+	const TableEntry *entry = &_tables[bits.peekBits(_prefixTableBits)];
+
+	while (entry->subTableBits) {
+		bits.skip(entry->length);
+		entry = &_tables[entry->symbol + bits.peekBits(entry->subTableBits)];
 	}
 
-	error("Unknown Huffman code");
-	return 0;
+	if (entry->length == 0xFF)
+		error("Unknown Huffman code");
+
+	bits.skip(entry->length);
+	return entry->symbol;
 }
 
 /** @} */
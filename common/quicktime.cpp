@@ -27,6 +27,7 @@
 // Seek function by Gael Chardon gael.dev@4now.net
 //
 
+#include "common/algorithm.h"
 #include "common/debug.h"
 #include "common/endian.h"
 #include "common/macresman.h"
@@ -603,6 +604,10 @@ int QuickTimeParser::readSTSS(Atom atom) {
 		debug(6, "keyframes[%d] = %d", i, track->keyframes[i]);
 
 	}
+
+	// The key frames are looked up with a binary search. They should already
+	// be in order, but don't rely on it.
+	Common::sort(track->keyframes, track->keyframes + track->keyframeCount);
 	return 0;
 }
 
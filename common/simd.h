@@ -0,0 +1,56 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_SIMD_H
+#define COMMON_SIMD_H
+
+#include "common/scummsys.h"
+
+/**
+ * @defgroup common_simd SIMD instruction sets
+ * @ingroup common
+ *
+ * @brief Selection of the vector instruction set for hand vectorized code.
+ *
+ * Only the instruction sets the target guarantees are used, which are SSE2
+ * on x86-64 and NEON on AArch64, so that no runtime CPU detection is needed
+ * to pick an implementation. Including this header defines
+ * SCUMMVM_SIMD_SSE2 or SCUMMVM_SIMD_NEON, along with SCUMMVM_SIMD, and
+ * includes the matching intrinsics. Code using them must keep a scalar
+ * version for the other targets.
+ *
+ * @{
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SCUMMVM_SIMD_SSE2
+#define SCUMMVM_SIMD
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SCUMMVM_SIMD_NEON
+#define SCUMMVM_SIMD
+#endif
+
+/** @} */
+
+#endif
@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include "devtools/bench/bench.h"
+
+namespace Bench {
+
+uint64 getMicroseconds() {
+	timeval time;
+	gettimeofday(&time, nullptr);
+	return (uint64)time.tv_sec * 1000000 + time.tv_usec;
+}
+
+uint64 getPeakMemoryKB() {
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef MACOSX
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+Options::Options(const char *files) : _files(files) {
+}
+
+void Options::addFlag(const char *name, bool &flag, const char *help) {
+	Option option = { name, help, &flag, nullptr, 0, 0 };
+	_options.push_back(option);
+}
+
+void Options::addNumber(const char *name, int &value, int minimum, const char *help) {
+	Option option = { name, help, nullptr, &value, value, minimum };
+	_options.push_back(option);
+}
+
+int Options::parse(int argc, char *argv[]) const {
+	int i = 1;
+	for (; i < argc && argv[i][0] == '-'; i++) {
+		uint j = 0;
+		while (j < _options.size() && strcmp(argv[i], _options[j].name))
+			j++;
+
+		if (j == _options.size()) {
+			printUsage(argv[0]);
+			return -1;
+		}
+
+		const Option &option = _options[j];
+		if (option.flag) {
+			*option.flag = true;
+		} else {
+			if (i + 1 == argc || atoi(argv[i + 1]) < option.minimum) {
+				printUsage(argv[0]);
+				return -1;
+			}
+			*option.value = atoi(argv[++i]);
+		}
+	}
+
+	if ((i == argc) != !_files) {
+		printUsage(argv[0]);
+		return -1;
+	}
+
+	return i;
+}
+
+void Options::printUsage(const char *name) const {
+	printf("Usage: %s", name);
+
+	uint width = 0;
+	for (uint i = 0; i < _options.size(); i++) {
+		const Option &option = _options[i];
+		printf(option.flag ? " [%s]" : " [%s <n>]", option.name);
+		width = MAX<uint>(width, strlen(option.name) + (option.flag ? 0 : 4));
+	}
+
+	if (_files)
+		printf(" %s...", _files);
+	printf("\n\n");
+
+	// The help may span several lines, which are aligned with the first one
+	for (uint i = 0; i < _options.size(); i++) {
+		const Option &option = _options[i];
+		const Common::String argument = option.flag ? option.name : Common::String::format("%s <n>", option.name);
+		printf("  %-*s  ", width, argument.c_str());
+
+		for (const char *help = option.help; *help; help++) {
+			putchar(*help);
+			if (*help == '\n')
+				printf("%*s", width + 4, "");
+		}
+
+		if (option.value)
+			printf(" (default: %d)", option.defaultValue);
+		printf(".\n");
+	}
+
+	if (!_notes.empty())
+		printf("\n%s\n", _notes.c_str());
+}
+
+} // End of namespace Bench
@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef DEVTOOLS_BENCH_H
+#define DEVTOOLS_BENCH_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+// Helpers shared by the benchmark tools in devtools/, which are linked against
+// the null OSystem of the unit tests, see devtools/bench/bench.mk.
+
+namespace Bench {
+
+/** Return a time in microseconds, to measure durations with. */
+uint64 getMicroseconds();
+
+/** Return the largest amount of memory the process used so far, in KiB. */
+uint64 getPeakMemoryKB();
+
+/**
+ * The command line options of a tool. The options come first, followed by
+ * the files the tool works on, if it takes any.
+ */
+class Options {
+public:
+	/**
+	 * @param files Name of the file arguments in the usage, e.g. "<video>",
+	 *              or nullptr if the tool takes no files
+	 */
+	Options(const char *files);
+
+	/** Add an option which sets a flag when given. */
+	void addFlag(const char *name, bool &flag, const char *help);
+
+	/**
+	 * Add an option followed by a number, which must not be less than the
+	 * minimum. The current value of the number is shown as its default.
+	 */
+	void addNumber(const char *name, int &value, int minimum, const char *help);
+
+	/** Set the text printed after the options in the usage. */
+	void setNotes(const Common::String &notes) { _notes = notes; }
+
+	/**
+	 * Parse the command line.
+	 *
+	 * @return the index of the first file in argv, or -1 if the command
+	 *         line is invalid, in which case the usage was printed
+	 */
+	int parse(int argc, char *argv[]) const;
+
+	void printUsage(const char *name) const;
+
+private:
+	struct Option {
+		const char *name;
+		const char *help;
+		bool *flag;
+		int *value;
+		int defaultValue;
+		int minimum;
+	};
+
+	Common::Array<Option> _options;
+	const char *_files;
+	Common::String _notes;
+};
+
+} // End of namespace Bench
+
+#endif
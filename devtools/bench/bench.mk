@@ -0,0 +1,29 @@
+# Common part of the module.mk files of the benchmark tools. These are linked
+# against the null OSystem of the unit tests, the helpers of devtools/bench/
+# and the objects and libraries listed in BENCH_DEPS, followed by the
+# libraries the null OSystem depends on.
+
+MODULE_DIRS += \
+	devtools/bench/
+
+TOOL_DEPS := \
+	devtools/bench/bench.o \
+	test/null_osystem.o \
+	backends/fs/posix/posix-fs-factory.o \
+	backends/fs/posix/posix-fs.o \
+	backends/fs/posix/posix-iostream.o \
+	backends/fs/abstract-fs.o \
+	backends/fs/stdiostream.o \
+	backends/modular-backend.o \
+	backends/mixer/null/null-mixer.o \
+	$(BENCH_DEPS) \
+	audio/libaudio.a \
+	math/libmath.a \
+	common/libcommon.a
+
+TOOL_LIBS := $(LIBS)
+
+BENCH_DEPS :=
+
+# Include common rules
+include $(srcdir)/rules.mk
@@ -0,0 +1,217 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Runs the FFT, RDFT, DCT and MDCT of common/ at the sizes used by the audio
+// and video codecs, and reports how long a transform takes, so that changes
+// to them can be measured outside of the codecs. A hash of the results allows
+// checking whether a change alters them.
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/array.h"
+#include "common/dct.h"
+#include "common/fft.h"
+#include "common/mdct.h"
+#include "common/rdft.h"
+
+#include "devtools/bench/bench.h"
+#include "test/null_osystem.h"
+
+// Xorshift generator with a fixed seed, so that all runs transform the same data
+static float nextRandom(uint32 &seed) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return (int32)seed / 2147483648.0f;
+}
+
+// FNV-1a over the bits of the results
+static uint32 hashFloats(const float *data, uint count) {
+	uint32 hash = 2166136261u;
+
+	for (uint i = 0; i < count; i++) {
+		uint32 value;
+		memcpy(&value, &data[i], sizeof(value));
+		for (int j = 0; j < 4; j++) {
+			hash ^= (value >> (j * 8)) & 0xFF;
+			hash *= 16777619u;
+		}
+	}
+
+	return hash;
+}
+
+// A transform of a given size, working in place on a buffer of floats
+class Transform {
+public:
+	virtual ~Transform() {}
+
+	// Number of floats read and written by run()
+	virtual uint getSize() const = 0;
+
+	virtual void run(float *data) = 0;
+};
+
+class FFTTransform : public Transform {
+public:
+	FFTTransform(int bits, bool inverse) : _fft(bits, inverse), _bits(bits) {}
+
+	uint getSize() const override { return 2 << _bits; }
+
+	void run(float *data) override {
+		_fft.permute((Common::Complex *)data);
+		_fft.calc((Common::Complex *)data);
+	}
+
+private:
+	Common::FFT _fft;
+	int _bits;
+};
+
+class RDFTTransform : public Transform {
+public:
+	RDFTTransform(int bits, Common::RDFT::TransformType type) : _rdft(bits, type), _bits(bits) {}
+
+	uint getSize() const override { return 1 << _bits; }
+
+	void run(float *data) override { _rdft.calc(data); }
+
+private:
+	Common::RDFT _rdft;
+	int _bits;
+};
+
+class DCTTransform : public Transform {
+public:
+	DCTTransform(int bits, Common::DCT::TransformType type) : _dct(bits, type), _bits(bits) {}
+
+	uint getSize() const override { return 1 << _bits; }
+
+	void run(float *data) override { _dct.calc(data); }
+
+private:
+	Common::DCT _dct;
+	int _bits;
+};
+
+// The inverse MDCT, as used by the audio codecs. Its output is twice the size
+// of its input.
+class IMDCTTransform : public Transform {
+public:
+	IMDCTTransform(int bits) : _mdct(bits, true, 1.0), _bits(bits) {
+		_output.resize(1 << bits);
+	}
+
+	uint getSize() const override { return 1 << (_bits - 1); }
+
+	void run(float *data) override {
+		_mdct.calcIMDCT(_output.begin(), data);
+		memcpy(data, _output.begin(), getSize() * sizeof(float));
+	}
+
+private:
+	Common::MDCT _mdct;
+	int _bits;
+	Common::Array<float> _output;
+};
+
+static void benchmarkTransform(const char *name, int bits, Transform &transform, uint32 samples, bool hash) {
+	const uint size = transform.getSize();
+	const uint32 count = MAX<uint32>(samples / size, 1);
+
+	Common::Array<float> input, data;
+	input.resize(size);
+	data.resize(size);
+
+	uint32 seed = 1;
+	for (uint i = 0; i < size; i++)
+		input[i] = nextRandom(seed);
+
+	// Every run transforms the same input, which is only a small copy next
+	// to the transform itself
+	uint64 startTime = Bench::getMicroseconds();
+	for (uint32 i = 0; i < count; i++) {
+		memcpy(data.begin(), input.begin(), size * sizeof(float));
+		transform.run(data.begin());
+	}
+	uint64 totalTime = Bench::getMicroseconds() - startTime;
+
+	printf("%-8s %5d: %8u transforms, %9.3f us/transform, %7.1f Msamples/s",
+	       name, 1 << bits, count, (double)totalTime / count,
+	       totalTime ? (double)count * size / totalTime : 0.0);
+	if (hash)
+		printf(", hash %08x", hashFloats(data.begin(), size));
+	printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+	int minBits = 6;
+	int maxBits = 12;
+	int samples = 16 * 1024 * 1024;
+	bool hash = false;
+
+	// The RDFT, and the DCT built on it, support between 4 and 16 bits
+	Bench::Options options(nullptr);
+	options.addNumber("--min-bits", minBits, 4, "Smallest transform size, as a power of two");
+	options.addNumber("--max-bits", maxBits, 4, "Largest transform size, as a power of two");
+	options.addNumber("--samples", samples, 1, "Number of input values run through each transform\nsize");
+	options.addFlag("--hash", hash, "Print a hash of the results of each transform");
+
+	if (options.parse(argc, argv) < 0)
+		return -1;
+
+	if (maxBits > 16 || minBits > maxBits) {
+		options.printUsage(argv[0]);
+		return -1;
+	}
+
+	// The transforms report errors through the OSystem
+	Common::install_null_g_system();
+
+	for (int bits = minBits; bits <= maxBits; bits++) {
+		FFTTransform fft(bits, false);
+		benchmarkTransform("FFT", bits, fft, samples, hash);
+
+		FFTTransform ifft(bits, true);
+		benchmarkTransform("IFFT", bits, ifft, samples, hash);
+
+		RDFTTransform rdft(bits, Common::RDFT::DFT_R2C);
+		benchmarkTransform("RDFT", bits, rdft, samples, hash);
+
+		RDFTTransform irdft(bits, Common::RDFT::IDFT_C2R);
+		benchmarkTransform("IRDFT", bits, irdft, samples, hash);
+
+		DCTTransform dct(bits, Common::DCT::DCT_II);
+		benchmarkTransform("DCT-II", bits, dct, samples, hash);
+
+		DCTTransform idct(bits, Common::DCT::DCT_III);
+		benchmarkTransform("DCT-III", bits, idct, samples, hash);
+
+		IMDCTTransform imdct(bits);
+		benchmarkTransform("IMDCT", bits, imdct, samples, hash);
+	}
+
+	return 0;
+}
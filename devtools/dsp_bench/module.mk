@@ -0,0 +1,17 @@
+ifdef POSIX
+
+MODULE := devtools/dsp_bench
+
+MODULE_OBJS := \
+	dsp_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := dsp_bench
+
+# The transforms are part of the common code, which all the benchmark tools
+# link in.
+BENCH_DEPS :=
+
+include $(srcdir)/devtools/bench/bench.mk
+
+endif
@@ -0,0 +1,224 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Decodes random symbol streams with Common::Huffman, for a few code sets and
+// bit stream types, and reports the decoding speed in MB/s of encoded data, so
+// that changes to the decoder or the bit streams can be measured outside of
+// the codecs using them. The decoded symbols are checked along the way.
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <string.h>
+
+#include "common/array.h"
+#include "common/bitstream.h"
+#include "common/huffman.h"
+
+#include "devtools/bench/bench.h"
+#include "test/null_osystem.h"
+
+// Number of codes of each length in a code set, the codes being canonical
+struct CodeLengthCount {
+	uint8 length;
+	uint16 count;
+};
+
+struct CodeSet {
+	const char *name;
+	const CodeLengthCount *lengths;
+	uint count;
+};
+
+// Codes no longer than the primary lookup table, like most of the Bink and
+// Smacker trees
+static const CodeLengthCount kShortCodes[] = {
+	{ 2, 2 }, { 3, 2 }, { 4, 1 }, { 5, 2 }, { 6, 4 }, { 7, 8 }
+};
+
+// All the 256 byte values with 8-bit codes
+static const CodeLengthCount kByteCodes[] = {
+	{ 8, 256 }
+};
+
+// Codes of up to 24 bits, which go through the secondary tables, like the
+// motion vector and coefficient codes of SVQ1 and Indeo
+static const CodeLengthCount kLongCodes[] = {
+	{ 2, 1 }, { 3, 2 }, { 5, 6 }, { 9, 60 }, { 10, 3 }, { 13, 100 }, { 17, 40 }, { 24, 10 }
+};
+
+static const CodeSet kCodeSets[] = {
+	{ "short codes", kShortCodes, ARRAYSIZE(kShortCodes) },
+	{ "byte codes", kByteCodes, ARRAYSIZE(kByteCodes) },
+	{ "long codes", kLongCodes, ARRAYSIZE(kLongCodes) }
+};
+
+// Xorshift generator with a fixed seed, so that all runs decode the same streams
+static uint32 nextRandom(uint32 &seed) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+class HuffmanBenchmark {
+public:
+	HuffmanBenchmark(const CodeSet &codeSet, uint32 symbolCount);
+
+	template<class BITSTREAM>
+	bool run(const char *streamName, int iterations);
+
+private:
+	const CodeSet &_codeSet;
+
+	// Codes with their first bit in the MSB, and the lengths of the codes
+	Common::Array<uint32> _codes;
+	Common::Array<uint8> _lengths;
+
+	// The symbols to encode, with a probability of 2^-length each
+	Common::Array<uint32> _symbols;
+	uint64 _bitCount;
+};
+
+HuffmanBenchmark::HuffmanBenchmark(const CodeSet &codeSet, uint32 symbolCount) : _codeSet(codeSet), _bitCount(0) {
+	uint32 code = 0;
+	uint8 length = 0;
+
+	for (uint i = 0; i < codeSet.count; i++) {
+		for (uint j = 0; j < codeSet.lengths[i].count; j++) {
+			code <<= codeSet.lengths[i].length - length;
+			length = codeSet.lengths[i].length;
+
+			_codes.push_back(code++);
+			_lengths.push_back(length);
+		}
+	}
+
+	// Cumulative probabilities of the symbols, in units of 2^-32
+	Common::Array<uint64> cumulative;
+	uint64 total = 0;
+	for (uint i = 0; i < _lengths.size(); i++) {
+		total += (uint64)1 << (32 - _lengths[i]);
+		cumulative.push_back(total);
+	}
+
+	uint32 seed = 1;
+	_symbols.reserve(symbolCount);
+	for (uint32 i = 0; i < symbolCount; i++) {
+		const uint64 value = ((uint64)nextRandom(seed) << 32 | nextRandom(seed)) % total;
+
+		uint first = 0, last = cumulative.size() - 1;
+		while (first < last) {
+			const uint middle = (first + last) / 2;
+			if (cumulative[middle] <= value)
+				first = middle + 1;
+			else
+				last = middle;
+		}
+
+		_symbols.push_back(first);
+		_bitCount += _lengths[first];
+	}
+}
+
+template<class BITSTREAM>
+bool HuffmanBenchmark::run(const char *streamName, int iterations) {
+	// The bit streams read up to four bytes past the last code
+	Common::Array<byte> data;
+	data.resize(_bitCount / 8 + 8);
+	memset(data.begin(), 0, data.size());
+
+	// The codes passed to Common::Huffman are in the order of the bits in the stream
+	Common::Array<uint32> codes;
+	for (uint i = 0; i < _codes.size(); i++)
+		codes.push_back(BITSTREAM::isMSB2LSB() ? _codes[i] : Common::REVERSEBITS(_codes[i]) >> (32 - _lengths[i]));
+
+	uint64 bitPos = 0;
+	for (uint32 i = 0; i < _symbols.size(); i++) {
+		const uint32 code = _codes[_symbols[i]];
+		const uint8 length = _lengths[_symbols[i]];
+
+		for (int j = length - 1; j >= 0; j--, bitPos++) {
+			if ((code >> j) & 1)
+				data[bitPos / 8] |= BITSTREAM::isMSB2LSB() ? 0x80 >> (bitPos % 8) : 1 << (bitPos % 8);
+		}
+	}
+
+	uint64 buildStartTime = Bench::getMicroseconds();
+	Common::Huffman<BITSTREAM> huffman(0, codes.size(), codes.begin(), _lengths.begin());
+	uint64 buildTime = Bench::getMicroseconds() - buildStartTime;
+
+	uint64 totalTime = 0;
+	for (int i = 0; i < iterations; i++) {
+		BITSTREAM bits(new Common::BitStreamMemoryStream(data.begin(), data.size()), DisposeAfterUse::YES);
+
+		uint64 startTime = Bench::getMicroseconds();
+		uint32 errors = 0;
+		for (uint32 j = 0; j < _symbols.size(); j++) {
+			if (huffman.getSymbol(bits) != _symbols[j])
+				errors++;
+		}
+		totalTime += Bench::getMicroseconds() - startTime;
+
+		if (errors) {
+			fprintf(stderr, "%s, %s: %u of %u symbols decoded wrongly\n", _codeSet.name, streamName, errors, _symbols.size());
+			return false;
+		}
+	}
+
+	const double seconds = totalTime / 1000000.0 / iterations;
+	printf("%s, %s: %u codes of up to %d bits, %.2f bits/symbol, build %.3f ms, %.1f MB/s, %.1f Msymbols/s\n",
+	       _codeSet.name, streamName, _codes.size(), _lengths.back(), (double)_bitCount / _symbols.size(), buildTime / 1000.0,
+	       seconds > 0 ? _bitCount / 8.0 / 1000000.0 / seconds : 0.0, seconds > 0 ? _symbols.size() / 1000000.0 / seconds : 0.0);
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	int symbolCount = 4000000;
+	int iterations = 5;
+
+	Bench::Options options(nullptr);
+	options.addNumber("--symbols", symbolCount, 1, "Number of symbols in each stream");
+	options.addNumber("--iterations", iterations, 1, "Number of times each stream is decoded");
+
+	if (options.parse(argc, argv) < 0)
+		return -1;
+
+	// Common::Huffman reports invalid codes through the OSystem
+	Common::install_null_g_system();
+
+	int result = 0;
+	for (uint i = 0; i < ARRAYSIZE(kCodeSets); i++) {
+		HuffmanBenchmark benchmark(kCodeSets[i], symbolCount);
+
+		if (!benchmark.run<Common::BitStreamMemory8MSB>("8-bit MSB", iterations))
+			result = 1;
+		if (!benchmark.run<Common::BitStreamMemory8LSB>("8-bit LSB", iterations))
+			result = 1;
+		if (!benchmark.run<Common::BitStreamMemory16BEMSB>("16-bit BE MSB", iterations))
+			result = 1;
+		if (!benchmark.run<Common::BitStreamMemory32LELSB>("32-bit LE LSB", iterations))
+			result = 1;
+	}
+
+	return result;
+}
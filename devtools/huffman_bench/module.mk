@@ -0,0 +1,17 @@
+ifdef POSIX
+
+MODULE := devtools/huffman_bench
+
+MODULE_OBJS := \
+	huffman_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := huffman_bench
+
+# Common::Huffman is header only, so nothing is linked in on top of the parts
+# shared by the benchmark tools.
+BENCH_DEPS :=
+
+include $(srcdir)/devtools/bench/bench.mk
+
+endif
@@ -0,0 +1,21 @@
+ifdef POSIX
+
+MODULE := devtools/text_bench
+
+MODULE_OBJS := \
+	text_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := text_bench
+
+# The fonts, the libraries they depend on and the null graphics manager, whose
+# checksums are used as hashes, are linked in on top of the parts shared by the
+# benchmark tools.
+BENCH_DEPS := \
+	backends/graphics/null/null-checksum-graphics.o \
+	graphics/libgraphics.a \
+	image/libimage.a
+
+include $(srcdir)/devtools/bench/bench.mk
+
+endif
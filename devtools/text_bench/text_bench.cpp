@@ -0,0 +1,240 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Word wraps and draws paragraphs of text with TTF and BDF fonts, at several
+// sizes, and reports how long laying out and drawing them takes, so that font
+// rendering changes can be measured outside of the engines and the GUI. A hash
+// of the rendered text allows checking whether a change alters the output.
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#include "backends/graphics/null/null-checksum-graphics.h"
+
+#include "common/array.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+
+#include "graphics/font.h"
+#include "graphics/fonts/bdf.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/surface.h"
+
+#include "devtools/bench/bench.h"
+#include "test/null_osystem.h"
+
+static const char *const kParagraphs[] = {
+	"The lighthouse keeper had not spoken to anyone in three weeks, and when "
+	"the knock finally came he stood behind the door for a long while, counting "
+	"the seconds between the flashes of the lamp above him. Outside, the wind "
+	"pulled at the shutters and the sea threw itself against the rocks.",
+
+	"\"You will want to see this,\" said the stranger, holding out a folded map "
+	"whose corners had been burnt away. Along its edge ran a line of tiny "
+	"numbers: 17, 42, 108, 7 and 256. Nobody in the village knew what they "
+	"meant, or who had drawn the coastline with such care.",
+
+	"He spread the map on the table, weighed its corners down with a kettle, "
+	"two tin cups and a jar of nails, and traced the path from the harbour to "
+	"the cliffs. Somewhere between the old chapel and the quarry, the ink turned "
+	"from black to a faded, rusty brown."
+};
+
+static const int kDefaultSizes[] = { 10, 14, 20, 32 };
+
+// Text and background colors the paragraphs are drawn with. Blending glyph
+// edges behaves differently for light text on a dark background and for dark
+// text on a light one, so both are covered by the hashes.
+struct ColorScheme {
+	const char *name;
+	byte textR, textG, textB;
+	byte backgroundR, backgroundG, backgroundB;
+};
+
+static const ColorScheme kColorSchemes[] = {
+	{ "light on dark", 255, 255, 255, 0, 0, 96 },
+	{ "dark on light", 0, 0, 0, 255, 255, 255 },
+	{ "colored", 255, 160, 32, 96, 112, 128 }
+};
+
+struct TextBenchmark {
+	Graphics::PixelFormat format;
+	int width;
+	int iterations;
+	bool hash;
+};
+
+static bool benchmarkFont(const char *name, const Graphics::Font &font, const TextBenchmark &benchmark, uint64 loadTime) {
+	const int lineHeight = MAX(font.getFontHeight(), 1);
+
+	// The first layout fills the caches of the font, later ones hit them
+	Common::Array<Common::String> lines[ARRAYSIZE(kParagraphs)];
+	uint glyphs = 0;
+
+	uint64 startTime = Bench::getMicroseconds();
+	for (uint i = 0; i < ARRAYSIZE(kParagraphs); i++)
+		font.wordWrapText(kParagraphs[i], benchmark.width, lines[i]);
+	uint64 firstLayoutTime = Bench::getMicroseconds() - startTime;
+
+	int height = 0;
+	for (uint i = 0; i < ARRAYSIZE(kParagraphs); i++) {
+		height += (lines[i].size() + 1) * lineHeight;
+		for (uint j = 0; j < lines[i].size(); j++)
+			glyphs += lines[i][j].size();
+	}
+
+	printf("%s: %d px lines, %d glyphs, load %.3f ms, first layout %.3f ms\n",
+	       name, lineHeight, glyphs, loadTime / 1000.0, firstLayoutTime / 1000.0);
+
+	Graphics::Surface surface;
+	surface.create(benchmark.width, height, benchmark.format);
+
+	for (uint scheme = 0; scheme < ARRAYSIZE(kColorSchemes); scheme++) {
+		const ColorScheme &colors = kColorSchemes[scheme];
+		const uint32 color = benchmark.format.RGBToColor(colors.textR, colors.textG, colors.textB);
+		const uint32 background = benchmark.format.RGBToColor(colors.backgroundR, colors.backgroundG, colors.backgroundB);
+
+		uint64 layoutTime = 0, drawTime = 0;
+		for (int iteration = 0; iteration < benchmark.iterations; iteration++) {
+			surface.fillRect(Common::Rect(surface.w, surface.h), background);
+
+			int y = 0;
+			for (uint i = 0; i < ARRAYSIZE(kParagraphs); i++) {
+				lines[i].clear();
+
+				uint64 layoutStartTime = Bench::getMicroseconds();
+				font.wordWrapText(kParagraphs[i], benchmark.width, lines[i]);
+				uint64 drawStartTime = Bench::getMicroseconds();
+				layoutTime += drawStartTime - layoutStartTime;
+
+				for (uint j = 0; j < lines[i].size(); j++, y += lineHeight)
+					font.drawString(&surface, lines[i][j], 0, y, benchmark.width, color);
+				drawTime += Bench::getMicroseconds() - drawStartTime;
+
+				y += lineHeight;
+			}
+		}
+
+		const double seconds = (layoutTime + drawTime) / 1000000.0;
+		printf("%s, %s: layout %.3f ms, draw %.3f ms, %.2f Mglyphs/s",
+		       name, colors.name, layoutTime / 1000.0 / benchmark.iterations, drawTime / 1000.0 / benchmark.iterations,
+		       seconds > 0 ? (double)glyphs * benchmark.iterations / 1000000.0 / seconds : 0.0);
+		if (benchmark.hash)
+			printf(", hash %08x", NullChecksumGraphicsManager::hashSurface(surface));
+		printf("\n");
+	}
+
+	surface.free();
+	return true;
+}
+
+static bool benchmarkFontFile(const char *fileName, const TextBenchmark &benchmark) {
+	Common::File file;
+	if (!file.open(Common::FSNode(fileName))) {
+		fprintf(stderr, "%s: Could not open the file\n", fileName);
+		return false;
+	}
+
+	const Common::String name(fileName);
+	if (name.hasSuffixIgnoreCase(".bdf")) {
+		uint64 loadStartTime = Bench::getMicroseconds();
+		Graphics::Font *font = Graphics::BdfFont::loadFont(file);
+		uint64 loadTime = Bench::getMicroseconds() - loadStartTime;
+
+		if (!font) {
+			fprintf(stderr, "%s: Could not load the font\n", fileName);
+			return false;
+		}
+
+		bool success = benchmarkFont(fileName, *font, benchmark, loadTime);
+		delete font;
+		return success;
+	}
+
+#ifdef USE_FREETYPE2
+	bool success = true;
+	for (uint i = 0; i < ARRAYSIZE(kDefaultSizes); i++) {
+		file.seek(0);
+
+		uint64 loadStartTime = Bench::getMicroseconds();
+		Graphics::Font *font = Graphics::loadTTFFont(file, kDefaultSizes[i]);
+		uint64 loadTime = Bench::getMicroseconds() - loadStartTime;
+
+		if (!font) {
+			fprintf(stderr, "%s: Could not load the font\n", fileName);
+			return false;
+		}
+
+		const Common::String sizeName = Common::String::format("%s at %d", fileName, kDefaultSizes[i]);
+		if (!benchmarkFont(sizeName.c_str(), *font, benchmark, loadTime))
+			success = false;
+		delete font;
+	}
+
+	return success;
+#else
+	fprintf(stderr, "%s: TTF fonts need FreeType support\n", fileName);
+	return false;
+#endif
+}
+
+int main(int argc, char *argv[]) {
+	TextBenchmark benchmark;
+	benchmark.width = 600;
+	benchmark.iterations = 200;
+	benchmark.hash = false;
+	bool rgb565 = false;
+
+	Common::String notes("TTF fonts are used at sizes");
+	for (uint i = 0; i < ARRAYSIZE(kDefaultSizes); i++)
+		notes += Common::String::format(" %d", kDefaultSizes[i]);
+	notes += ", BDF fonts at their own size.";
+
+	Bench::Options options("<font>");
+	options.addFlag("--rgb565", rgb565, "Draw to a 16-bit surface instead of a 32-bit one");
+	options.addNumber("--width", benchmark.width, 1, "Width to wrap the paragraphs to");
+	options.addNumber("--iterations", benchmark.iterations, 1, "Number of times the paragraphs are laid out and\ndrawn with each font");
+	options.addFlag("--hash", benchmark.hash, "Print a hash of the paragraphs drawn with each color\nscheme");
+	options.setNotes(notes);
+
+	int i = options.parse(argc, argv);
+	if (i < 0)
+		return -1;
+
+	if (rgb565)
+		benchmark.format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	else
+		benchmark.format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+	// The fonts report warnings through the OSystem
+	Common::install_null_g_system();
+
+	int result = 0;
+	for (; i < argc; i++) {
+		if (!benchmarkFontFile(argv[i], benchmark))
+			result = 1;
+	}
+
+	return result;
+}
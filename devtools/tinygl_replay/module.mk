@@ -0,0 +1,21 @@
+ifdef USE_TINYGL
+ifdef POSIX
+
+MODULE := devtools/tinygl_replay
+
+MODULE_OBJS := \
+	tinygl_replay.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := tinygl_replay
+
+# TinyGL and the libraries it depends on are linked in on top of the parts
+# shared by the benchmark tools.
+BENCH_DEPS := \
+	graphics/libgraphics.a \
+	image/libimage.a
+
+include $(srcdir)/devtools/bench/bench.mk
+
+endif
+endif
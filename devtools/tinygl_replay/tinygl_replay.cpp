@@ -0,0 +1,153 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Replays TinyGL frame captures made with TinyGL::captureNextFrame() and
+// reports how long rendering them takes, so that rasterizer changes can be
+// measured outside of the engines.
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common/endian.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/rect.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/tinygl/tinygl.h"
+
+#include "devtools/bench/bench.h"
+#include "test/null_osystem.h"
+
+static byte *readFile(const char *fileName, uint32 &size) {
+	FILE *file = fopen(fileName, "rb");
+	if (!file)
+		return nullptr;
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	byte *data = (byte *)malloc(size);
+	if (data && fread(data, 1, size, file) != size) {
+		free(data);
+		data = nullptr;
+	}
+
+	fclose(file);
+	return data;
+}
+
+static bool replayCapture(const char *fileName, bool dirtyRects, bool rgb565, int iterations) {
+	uint32 size = 0;
+	byte *data = readFile(fileName, size);
+	if (!data) {
+		fprintf(stderr, "%s: Could not read the capture\n", fileName);
+		return false;
+	}
+
+	// Header: tag, version, then the screen and texture size of the context
+	// the capture was made with
+	if (size < 14 || READ_BE_UINT32(data) != MKTAG('T', 'G', 'L', 'F')) {
+		fprintf(stderr, "%s: Not a TinyGL frame capture\n", fileName);
+		free(data);
+		return false;
+	}
+
+	int width = READ_LE_UINT16(data + 8);
+	int height = READ_LE_UINT16(data + 10);
+	int textureSize = READ_LE_UINT16(data + 12);
+
+	Graphics::PixelFormat format;
+	if (rgb565)
+		format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	else
+		format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+	TinyGL::createContext(width, height, format, textureSize, true, dirtyRects);
+
+	Common::MemoryReadStream stream(data, size);
+	Common::List<Common::Rect> dirtyAreas;
+	uint64 pixelsPresented = 0;
+	uint64 firstFrameTime = 0;
+	bool success = true;
+
+	uint64 startTime = Bench::getMicroseconds();
+	for (int i = 0; i < iterations; i++) {
+		uint64 frameStartTime = Bench::getMicroseconds();
+
+		stream.seek(0);
+		if (!TinyGL::replayFrame(&stream)) {
+			fprintf(stderr, "%s: Could not replay the capture\n", fileName);
+			success = false;
+			break;
+		}
+
+		dirtyAreas.clear();
+		TinyGL::presentBuffer(dirtyAreas);
+
+		for (Common::List<Common::Rect>::const_iterator it = dirtyAreas.begin(); it != dirtyAreas.end(); ++it)
+			pixelsPresented += it->width() * it->height();
+
+		if (i == 0)
+			firstFrameTime = Bench::getMicroseconds() - frameStartTime;
+	}
+	uint64 totalTime = Bench::getMicroseconds() - startTime;
+
+	if (success) {
+		printf("%s: %dx%d, %d iterations, %.3f ms/frame (first frame %.3f ms), %.0f pixels presented/frame\n",
+		       fileName, width, height, iterations, totalTime / 1000.0 / iterations, firstFrameTime / 1000.0,
+		       (double)pixelsPresented / iterations);
+	}
+
+	TinyGL::destroyContext();
+	free(data);
+	return success;
+}
+
+int main(int argc, char *argv[]) {
+	bool dirtyRects = false;
+	bool rgb565 = false;
+	int iterations = 100;
+
+	Bench::Options options("<capture>");
+	options.addFlag("--dirty-rects", dirtyRects, "Render with dirty rects enabled. Iterations after the\nfirst only redraw the draw calls found to differ from\nthe previous iteration, as textures are re-uploaded");
+	options.addFlag("--rgb565", rgb565, "Render to a 16-bit frame buffer instead of a 32-bit one");
+	options.addNumber("--iterations", iterations, 1, "Number of times each capture is replayed");
+
+	int i = options.parse(argc, argv);
+	if (i < 0)
+		return -1;
+
+	// TinyGL reports warnings through the OSystem
+	Common::install_null_g_system();
+
+	int result = 0;
+	for (; i < argc; i++) {
+		if (!replayCapture(argv[i], dirtyRects, rgb565, iterations))
+			result = 1;
+	}
+
+	return result;
+}
@@ -0,0 +1,22 @@
+ifdef POSIX
+
+MODULE := devtools/video_bench
+
+MODULE_OBJS := \
+	video_bench.o
+
+# Set the name of the executable
+TOOL_EXECUTABLE := video_bench
+
+# The decoders, the libraries they depend on and the null graphics manager,
+# whose checksums are used as hashes, are linked in on top of the parts shared
+# by the benchmark tools.
+BENCH_DEPS := \
+	backends/graphics/null/null-checksum-graphics.o \
+	video/libvideo.a \
+	image/libimage.a \
+	graphics/libgraphics.a
+
+include $(srcdir)/devtools/bench/bench.mk
+
+endif
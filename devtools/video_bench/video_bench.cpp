@@ -0,0 +1,249 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Decodes videos as fast as possible through the Video::VideoDecoder matching
+// their file extension, and reports how long decoding and converting the frames
+// to the screen format takes, so that decoder changes can be measured outside
+// of the engines. Per-frame hashes of the converted frames allow checking that
+// a change does not alter the output.
+
+// Disable symbol overrides so that we can use system headers.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#include "backends/graphics/null/null-checksum-graphics.h"
+
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+
+#include "video/avi_decoder.h"
+#include "video/bink_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/mpegps_decoder.h"
+#include "video/psx_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+#include "video/theora_decoder.h"
+
+#include "devtools/bench/bench.h"
+
+// The null OSystem of the unit tests, which the decoders get the screen format
+// and the mixer from
+#include "test/null_osystem.h"
+
+static Video::VideoDecoder *createDecoder(const Common::String &fileName) {
+	if (fileName.hasSuffixIgnoreCase(".avi"))
+		return new Video::AVIDecoder();
+#ifdef USE_BINK
+	if (fileName.hasSuffixIgnoreCase(".bik"))
+		return new Video::BinkDecoder();
+#endif
+	if (fileName.hasSuffixIgnoreCase(".dxa"))
+		return new Video::DXADecoder();
+	if (fileName.hasSuffixIgnoreCase(".fli") || fileName.hasSuffixIgnoreCase(".flc"))
+		return new Video::FlicDecoder();
+	if (fileName.hasSuffixIgnoreCase(".mov") || fileName.hasSuffixIgnoreCase(".qt"))
+		return new Video::QuickTimeDecoder();
+#ifdef USE_MPEG2
+	if (fileName.hasSuffixIgnoreCase(".mpg") || fileName.hasSuffixIgnoreCase(".m2v"))
+		return new Video::MPEGPSDecoder();
+#endif
+	if (fileName.hasSuffixIgnoreCase(".str"))
+		return new Video::PSXStreamDecoder(Video::PSXStreamDecoder::kCD2x);
+	if (fileName.hasSuffixIgnoreCase(".smk"))
+		return new Video::SmackerDecoder();
+#ifdef USE_THEORADEC
+	if (fileName.hasSuffixIgnoreCase(".ogv"))
+		return new Video::TheoraDecoder();
+#endif
+	return nullptr;
+}
+
+enum BenchMode {
+	kBenchDecode,	///< Only decode the frames
+	kBenchConvert,	///< Decode the frames, then convert them to the output
+	kBenchInto		///< Decode the frames straight into the output
+};
+
+struct BenchResult {
+	int frames;
+	uint64 loadTime;
+	uint64 decodeTime;
+	uint64 convertTime;
+};
+
+static bool runVideo(const char *fileName, Graphics::Surface &output, const Graphics::PixelFormat &format, BenchMode mode, bool hashes, BenchResult &result) {
+	Video::VideoDecoder *decoder = createDecoder(fileName);
+	if (!decoder) {
+		fprintf(stderr, "%s: No decoder for this file type\n", fileName);
+		return false;
+	}
+
+	Common::File *file = new Common::File();
+	if (!file->open(Common::FSNode(fileName))) {
+		fprintf(stderr, "%s: Could not open the file\n", fileName);
+		delete file;
+		delete decoder;
+		return false;
+	}
+
+	uint64 loadStartTime = Bench::getMicroseconds();
+	if (!decoder->loadStream(file)) {
+		fprintf(stderr, "%s: Could not load the video\n", fileName);
+		delete decoder;
+		return false;
+	}
+	result.loadTime = Bench::getMicroseconds() - loadStartTime;
+
+	if (!output.getPixels())
+		output.create(decoder->getWidth(), decoder->getHeight(), format);
+
+	// The output surface is kept from one frame to the next
+	decoder->setPartialFrameWrites(true);
+
+	const byte *palette = nullptr;
+	result.frames = 0;
+	result.decodeTime = 0;
+	result.convertTime = 0;
+	bool success = true;
+
+	while (!decoder->endOfVideo()) {
+		uint64 frameStartTime = Bench::getMicroseconds();
+
+		if (mode == kBenchInto) {
+			const bool decoded = decoder->decodeNextFrameInto(output);
+			result.decodeTime += Bench::getMicroseconds() - frameStartTime;
+
+			if (!decoded)
+				continue;
+		} else {
+			const Graphics::Surface *frame = decoder->decodeNextFrame();
+			if (decoder->hasDirtyPalette())
+				palette = decoder->getPalette();
+
+			uint64 convertStartTime = Bench::getMicroseconds();
+			result.decodeTime += convertStartTime - frameStartTime;
+
+			if (!frame)
+				continue;
+
+			if (mode == kBenchConvert) {
+				if (!Video::VideoDecoder::copyFrame(output, *frame, palette)) {
+					fprintf(stderr, "%s: Could not convert frame %d from %s\n", fileName, result.frames, frame->format.toString().c_str());
+					success = false;
+					break;
+				}
+
+				result.convertTime += Bench::getMicroseconds() - convertStartTime;
+			}
+		}
+
+		if (hashes && mode != kBenchDecode)
+			printf("%s: frame %d: %08x\n", fileName, decoder->getCurFrame(), NullChecksumGraphicsManager::hashSurface(output));
+
+		result.frames++;
+	}
+
+	delete decoder;
+	return success;
+}
+
+static bool benchmarkVideo(const char *fileName, const Graphics::PixelFormat &format, bool into, bool hashes) {
+	Graphics::Surface output;
+
+	BenchResult result;
+	bool success;
+
+	if (into) {
+		// Frames written into the output are converted while they are
+		// decoded, so the video is decoded once more without an output, and
+		// the difference is reported as the conversion time
+		BenchResult decodeResult;
+		success = runVideo(fileName, output, format, kBenchDecode, false, decodeResult) &&
+		          runVideo(fileName, output, format, kBenchInto, hashes, result);
+
+		if (success) {
+			const uint64 intoTime = result.decodeTime;
+			result.decodeTime = MIN(decodeResult.decodeTime, intoTime);
+			result.convertTime = intoTime - result.decodeTime;
+		}
+	} else {
+		success = runVideo(fileName, output, format, kBenchConvert, hashes, result);
+	}
+
+	if (success) {
+		const double totalTime = (result.decodeTime + result.convertTime) / 1000000.0;
+		const int frames = result.frames;
+
+		printf("%s: %dx%d, %d frames in %.3f s, %.1f fps, load %.3f ms, ", fileName,
+		       output.w, output.h, frames, totalTime, totalTime > 0 ? frames / totalTime : 0.0, result.loadTime / 1000.0);
+		printf("decode %.3f ms/frame, convert %.3f ms/frame", frames ? result.decodeTime / 1000.0 / frames : 0.0, frames ? result.convertTime / 1000.0 / frames : 0.0);
+		printf(", peak memory %llu KiB\n", (unsigned long long)Bench::getPeakMemoryKB());
+	}
+
+	output.free();
+	return success;
+}
+
+int main(int argc, char *argv[]) {
+	bool rgb565 = false;
+	bool into = false;
+	bool hashes = false;
+
+	Bench::Options options("<video>");
+	options.addFlag("--rgb565", rgb565, "Convert the frames to RGB565 instead of RGBA8888");
+	options.addFlag("--into", into, "Decode with VideoDecoder::decodeNextFrameInto(), which lets\n"
+	                "the decoders convert the frames while writing them. The\n"
+	                "video is decoded once more without converting the frames,\n"
+	                "and the difference is reported as the conversion time");
+	options.addFlag("--hashes", hashes, "Print a hash of every converted frame");
+	options.setNotes("The decoder is chosen from the file extension: avi, bik, dxa, fli, flc,\n"
+	                 "mov, mpg, str, smk or ogv. Audio is decoded along with the video when the\n"
+	                 "decoder interleaves it, but it is not played.");
+
+	int i = options.parse(argc, argv);
+	if (i < 0)
+		return -1;
+
+	Graphics::PixelFormat format;
+	if (rgb565)
+		format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+	else
+		format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+	// Decoders converting to RGB use the screen format
+	Common::install_null_g_system();
+	g_system->initSize(320, 200, &format);
+
+	int result = 0;
+	for (; i < argc; i++) {
+		if (!benchmarkVideo(argv[i], format, into, hashes))
+			result = 1;
+	}
+
+	return result;
+}
@@ -23,6 +23,7 @@
 #include "graphics/renderer.h"
 
 #include "engines/grim/debugger.h"
+#include "engines/grim/gfx_base.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
 
@@ -37,6 +38,7 @@ Debugger::Debugger() :
 	registerCmd("set_renderer", WRAP_METHOD(Debugger, cmd_set_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("capture_frame", WRAP_METHOD(Debugger, cmd_capture_frame));
 }
 
 Debugger::~Debugger() {
@@ -126,4 +128,18 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_capture_frame(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Usage: capture_frame <file name>\n");
+		debugPrintf("Saves the next frame drawn by the software renderer, to be replayed with tinygl_replay\n");
+		return true;
+	}
+	if (!g_driver->captureNextFrame(argv[1])) {
+		debugPrintf("Could not capture to '%s'. Frame captures need the software renderer.\n", argv[1]);
+		return true;
+	}
+	// Close the debugger, so that the frame gets drawn
+	return false;
+}
+
 }
@@ -110,6 +110,14 @@ public:
 	 */
 	virtual void flipBuffer() = 0;
 
+	/**
+	 * Saves the draw calls of the next frame to a file, so that it can be
+	 * rendered again with devtools/tinygl_replay.
+	 * @return false if the renderer does not support frame captures, or the
+	 *         file could not be created.
+	 */
+	virtual bool captureNextFrame(const Common::String &fileName) { return false; }
+
 	/**
 	 * FIXME: The implementations of these functions (for Grim and EMI, respectively)
 	 * are very similar. Needs refactoring. See issue #789.
@@ -49,7 +49,7 @@ GfxBase *CreateGfxTinyGL() {
 GfxTinyGL::GfxTinyGL() :
 		_alpha(1.f),
 		_currentActor(nullptr), _smushImage(nullptr),
-		_storedDisplay(nullptr) {
+		_storedDisplay(nullptr), _frameCapture(nullptr) {
 	// TGL_LEQUAL as tglDepthFunc ensures that subsequent drawing attempts for
 	// the same triangles are not ignored by the depth test.
 	// That's necessary for EMI where some models have multiple faces which
@@ -72,6 +72,7 @@ GfxTinyGL::~GfxTinyGL() {
 		tglDeleteBlitImage(_emergFont[i]);
 	}
 	TinyGL::destroyContext();
+	delete _frameCapture;
 }
 
 void GfxTinyGL::setupScreen(int screenW, int screenH) {
@@ -174,23 +175,50 @@ void GfxTinyGL::clearDepthBuffer() {
 	tglClear(TGL_DEPTH_BUFFER_BIT);
 }
 
+// Draw calls are only rendered when TinyGL presents the frame, so reading the
+// frame buffer in the middle of a frame first needs to render what was issued
+// so far. The areas this changes are sent to the screen by the next flip.
+void GfxTinyGL::renderPendingDrawCalls() {
+	if (TinyGL::hasPendingDrawCalls())
+		TinyGL::presentBuffer(_dirtyAreas);
+}
+
 void GfxTinyGL::flipBuffer() {
-	Common::List<Common::Rect> dirtyAreas;
-	TinyGL::presentBuffer(dirtyAreas);
+	TinyGL::presentBuffer(_dirtyAreas);
+
+	if (_frameCapture) {
+		_frameCapture->finalize();
+		delete _frameCapture;
+		_frameCapture = nullptr;
+	}
 
 	Graphics::Surface glBuffer;
 	TinyGL::getSurfaceRef(glBuffer);
 
-	if (!dirtyAreas.empty()) {
-		for (Common::List<Common::Rect>::iterator itRect = dirtyAreas.begin(); itRect != dirtyAreas.end(); ++itRect) {
-			g_system->copyRectToScreen(glBuffer.getBasePtr((*itRect).left, (*itRect).top), glBuffer.pitch,
-			                           (*itRect).left, (*itRect).top, (*itRect).width(), (*itRect).height());
-		}
+	for (Common::List<Common::Rect>::iterator itRect = _dirtyAreas.begin(); itRect != _dirtyAreas.end(); ++itRect) {
+		g_system->copyRectToScreen(glBuffer.getBasePtr((*itRect).left, (*itRect).top), glBuffer.pitch,
+		                           (*itRect).left, (*itRect).top, (*itRect).width(), (*itRect).height());
 	}
+	_dirtyAreas.clear();
 
 	g_system->updateScreen();
 }
 
+bool GfxTinyGL::captureNextFrame(const Common::String &fileName) {
+	if (_frameCapture)
+		return false;
+
+	_frameCapture = new Common::DumpFile();
+	if (!_frameCapture->open(fileName)) {
+		delete _frameCapture;
+		_frameCapture = nullptr;
+		return false;
+	}
+
+	TinyGL::captureNextFrame(_frameCapture);
+	return true;
+}
+
 bool GfxTinyGL::isHardwareAccelerated() {
 	return false;
 }
@@ -1248,6 +1276,7 @@ Bitmap *GfxTinyGL::getScreenshot(int w, int h, bool useStored) {
 	if (useStored) {
 		bmp = createScreenshotBitmap(_storedDisplay, w, h, true);
 	} else {
+		renderPendingDrawCalls();
 		Graphics::Surface *src = TinyGL::copyToBuffer(_pixelFormat);
 		bmp = createScreenshotBitmap(src, w, h, true);
 		src->free();
@@ -1262,7 +1291,7 @@ void GfxTinyGL::createSpecialtyTextureFromScreen(uint id, uint8 *data, int x, in
 }
 
 void GfxTinyGL::storeDisplay() {
-	TinyGL::presentBuffer();
+	renderPendingDrawCalls();
 	_storedDisplay->free();
 	delete _storedDisplay;
 	_storedDisplay = TinyGL::copyToBuffer(_pixelFormat);
@@ -1508,6 +1537,8 @@ void GfxTinyGL::readPixels(int x, int y, int width, int height, uint8 *buffer) {
 	assert(x < _screenWidth);
 	assert(y < _screenHeight);
 
+	renderPendingDrawCalls();
+
 	Graphics::Surface glBuffer;
 	TinyGL::getSurfaceRef(glBuffer);
 	uint8 r, g, b;
@@ -1516,7 +1547,7 @@ void GfxTinyGL::readPixels(int x, int y, int width, int height, uint8 *buffer) {
 			if ((j + x) >= _screenWidth || (i + y) >= _screenHeight) {
 				buffer[0] = buffer[1] = buffer[2] = 0;
 			} else {
-				uint32 pixel = glBuffer.getPixel(j, i);
+				uint32 pixel = glBuffer.getPixel(j + x, i + y);
 				glBuffer.format.colorToRGB(pixel, r, g, b);
 				buffer[0] = r;
 				buffer[1] = g;
@@ -24,6 +24,8 @@
 
 #include "engines/grim/gfx_base.h"
 
+#include "common/file.h"
+
 #include "graphics/tinygl/tinygl.h"
 
 namespace Graphics {
@@ -55,6 +57,7 @@ public:
 	void clearScreen() override;
 	void clearDepthBuffer() override;
 	void flipBuffer() override;
+	bool captureNextFrame(const Common::String &fileName) override;
 
 	bool isHardwareAccelerated() override;
 	bool supportsShaders() override;
@@ -137,7 +140,10 @@ private:
 	float _alpha;
 	const Actor *_currentActor;
 	TGLenum _depthFunc;
+	Common::List<Common::Rect> _dirtyAreas;
+	Common::DumpFile *_frameCapture;
 
+	void renderPendingDrawCalls();
 	void readPixels(int x, int y, int width, int height, uint8 *buffer);
 };
 
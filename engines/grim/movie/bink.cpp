@@ -43,6 +43,8 @@ MoviePlayer *CreateBinkPlayer(bool demo) {
 BinkPlayer::BinkPlayer(bool demo) : MoviePlayer(), _demo(demo) {
 	_videoDecoder = new Video::BinkDecoder();
 	_videoDecoder->setDefaultHighColorFormat(Graphics::PixelFormat(4, 8, 8, 8, 0, 8, 16, 24, 0));
+	// Keyframes take much longer to decode than the other frames
+	_videoDecoder->setDecodeAheadFrames(2);
 	_subtitleIndex = _subtitles.begin();
 }
 
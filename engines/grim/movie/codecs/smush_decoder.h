@@ -61,6 +61,7 @@ protected:
 	void init();
 	void close() override;
 	const Graphics::Surface *decodeNextFrame() override;
+	bool decodeNextFrameInto(Graphics::Surface &dst) override { return copyNextFrameInto(dst); }
 	class SmushVideoTrack : public FixedRateVideoTrack {
 	public:
 		SmushVideoTrack(int width, int height, int fps, int numFrames, bool is16Bit);
@@ -98,8 +98,10 @@ bool MoviePlayer::prepareFrame() {
 		return false;
 	}
 
-	if (_videoDecoder->getTimeToNextFrame() > 0)
+	if (_videoDecoder->getTimeToNextFrame() > 0) {
+		_videoDecoder->decodeAhead();
 		return false;
+	}
 
 	handleFrame();
 	_internalSurface = _videoDecoder->decodeNextFrame();
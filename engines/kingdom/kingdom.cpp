@@ -505,17 +505,16 @@ void KingdomGame::playMovie(int movieNum) {
 			unsigned int delay = MIN<uint32>(decoder->getTimeToNextFrame(), 10u);
 			g_system->delayMillis(delay);
 
-			const Graphics::Surface *frame = nullptr;
+			bool decoded = false;
 
 			if (decoder->needsUpdate()) {
-				frame = decoder->decodeNextFrame();
-			}
-
-			if (frame) {
 				::Graphics::Surface *screen = g_system->lockScreen();
-				screen->copyRectToSurface(*frame, x, y, Common::Rect(frame->w, frame->h));
+				::Graphics::Surface area = screen->getSubArea(Common::Rect(x, y, x + decoder->getWidth(), y + decoder->getHeight()));
+				decoded = decoder->decodeNextFrameInto(area);
 				g_system->unlockScreen();
+			}
 
+			if (decoded) {
 				if (decoder->hasDirtyPalette()) {
 					PaletteManager *paletteManager = g_system->getPaletteManager();
 					decoder->applyPalette(paletteManager);
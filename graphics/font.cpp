@@ -23,10 +23,156 @@
 #include "graphics/managed_surface.h"
 
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/util.h"
 
 namespace Graphics {
 
+namespace {
+
+/** Maximum number of strings memoized by a font's word wrap cache. */
+enum {
+	kWordWrapCacheSize = 256
+};
+
+template<class StringType>
+struct WordWrapKey {
+	StringType str;
+	int maxWidth;
+	int initWidth;
+	uint32 mode;
+
+	bool operator==(const WordWrapKey &other) const {
+		return maxWidth == other.maxWidth && initWidth == other.initWidth
+		    && mode == other.mode && str == other.str;
+	}
+};
+
+template<class StringType>
+struct WordWrapKey_Hash {
+	uint operator()(const WordWrapKey<StringType> &key) const {
+		uint hash = Common::Hash<StringType>()(key.str);
+		hash = hash * 31 + key.maxWidth;
+		hash = hash * 31 + key.initWidth;
+		return hash * 31 + key.mode;
+	}
+};
+
+template<class StringType>
+struct WordWrapResult {
+	Common::Array<StringType> lines;
+	int maxLineWidth;
+};
+
+/**
+ * Results memoized for one string type. The entries are kept in a list
+ * ordered by their last use, linked through their indices, so that when the
+ * cache is full the least recently used one makes room for the new one.
+ */
+template<class StringType>
+class WordWrapStringCache {
+public:
+	WordWrapStringCache() : _first(-1), _last(-1) {}
+
+	void clear() {
+		_entries.clear();
+		_index.clear();
+		_first = _last = -1;
+	}
+
+	/** Returns the result stored for the key, if any, and marks it as used. */
+	const WordWrapResult<StringType> *find(const WordWrapKey<StringType> &key) {
+		typename IndexMap::const_iterator i = _index.find(key);
+		if (i == _index.end())
+			return nullptr;
+
+		detach(i->_value);
+		attachFirst(i->_value);
+		return &_entries[i->_value].result;
+	}
+
+	void insert(const WordWrapKey<StringType> &key, const WordWrapResult<StringType> &result) {
+		int entry;
+		if (_entries.size() < (uint)kWordWrapCacheSize) {
+			entry = _entries.size();
+			_entries.push_back(Entry());
+		} else {
+			entry = _last;
+			detach(entry);
+			_index.erase(_entries[entry].key);
+		}
+
+		_entries[entry].key = key;
+		_entries[entry].result = result;
+		attachFirst(entry);
+		_index[key] = entry;
+	}
+
+private:
+	struct Entry {
+		WordWrapKey<StringType> key;
+		WordWrapResult<StringType> result;
+		int previous, next;
+	};
+
+	typedef Common::HashMap<WordWrapKey<StringType>, int, WordWrapKey_Hash<StringType> > IndexMap;
+
+	void detach(int entry) {
+		Entry &e = _entries[entry];
+		if (e.previous >= 0)
+			_entries[e.previous].next = e.next;
+		else
+			_first = e.next;
+		if (e.next >= 0)
+			_entries[e.next].previous = e.previous;
+		else
+			_last = e.previous;
+	}
+
+	void attachFirst(int entry) {
+		Entry &e = _entries[entry];
+		e.previous = -1;
+		e.next = _first;
+		if (_first >= 0)
+			_entries[_first].previous = entry;
+		else
+			_last = entry;
+		_first = entry;
+	}
+
+	Common::Array<Entry> _entries;
+	IndexMap _index;
+	// Most and least recently used entries
+	int _first, _last;
+};
+
+} // End of anonymous namespace
+
+struct Font::WordWrapCache {
+	WordWrapStringCache<Common::String> strings;
+	WordWrapStringCache<Common::U32String> u32Strings;
+};
+
+Font::Font() : _wordWrapCacheEnabled(false) {
+}
+
+Font::~Font() {
+}
+
+void Font::setWordWrapCacheEnabled(bool enable) {
+	_wordWrapCacheEnabled = enable;
+	if (!enable)
+		_wordWrapCache.reset();
+}
+
+void Font::invalidateWordWrapCache() {
+	if (_wordWrapCache) {
+		_wordWrapCache->strings.clear();
+		_wordWrapCache->u32Strings.clear();
+	}
+}
+
 int Font::getFontAscent() const {
 	return -1;
 }
@@ -481,12 +627,51 @@ void Font::drawString(ManagedSurface *dst, const Common::U32String &str, int x,
 	}
 }
 
+template<class StringType, class CacheType>
+int Font::wordWrapTextCached(CacheType &cache, const StringType &str, int maxWidth, Common::Array<StringType> &lines, int initWidth, uint32 mode) const {
+	WordWrapKey<StringType> key;
+	key.str = str;
+	key.maxWidth = maxWidth;
+	key.initWidth = initWidth;
+	key.mode = mode;
+
+	const WordWrapResult<StringType> *cached = cache.find(key);
+	if (cached) {
+		for (uint i = 0; i < cached->lines.size(); ++i)
+			lines.push_back(cached->lines[i]);
+		return cached->maxLineWidth;
+	}
+
+	WordWrapResult<StringType> result;
+	result.maxLineWidth = wordWrapTextImpl(*this, str, maxWidth, result.lines, initWidth, mode);
+	for (uint i = 0; i < result.lines.size(); ++i)
+		lines.push_back(result.lines[i]);
+
+	// Keep the memory bounded, without dropping the strings which are redrawn
+	// all the time
+	cache.insert(key, result);
+
+	return result.maxLineWidth;
+}
+
 int Font::wordWrapText(const Common::String &str, int maxWidth, Common::Array<Common::String> &lines, int initWidth, uint32 mode) const {
-	return wordWrapTextImpl(*this, str, maxWidth, lines, initWidth, mode);
+	// Even width lines mode discards lines already present in the output
+	// array, which the cache can not reproduce.
+	if (!_wordWrapCacheEnabled || ((mode & kWordWrapEvenWidthLines) && !lines.empty()))
+		return wordWrapTextImpl(*this, str, maxWidth, lines, initWidth, mode);
+
+	if (!_wordWrapCache)
+		_wordWrapCache.reset(new WordWrapCache());
+	return wordWrapTextCached(_wordWrapCache->strings, str, maxWidth, lines, initWidth, mode);
 }
 
 int Font::wordWrapText(const Common::U32String &str, int maxWidth, Common::Array<Common::U32String> &lines, int initWidth, uint32 mode) const {
-	return wordWrapTextImpl(*this, str, maxWidth, lines, initWidth, mode);
+	if (!_wordWrapCacheEnabled || ((mode & kWordWrapEvenWidthLines) && !lines.empty()))
+		return wordWrapTextImpl(*this, str, maxWidth, lines, initWidth, mode);
+
+	if (!_wordWrapCache)
+		_wordWrapCache.reset(new WordWrapCache());
+	return wordWrapTextCached(_wordWrapCache->u32Strings, str, maxWidth, lines, initWidth, mode);
 }
 
 TextAlign convertTextAlignH(TextAlign alignH, bool rtl) {
@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
+#include "common/ptr.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/rect.h"
@@ -81,8 +82,8 @@ TextAlign convertTextAlignH(TextAlign alignH, bool rtl);
  */
 class Font {
 public:
-	Font() {}
-	virtual ~Font() {}
+	Font();
+	virtual ~Font();
 
 	/**
 	 * Return the height of the font.
@@ -251,6 +252,32 @@ public:
 	int wordWrapText(const Common::String &str, int maxWidth, Common::Array<Common::String> &lines, int initWidth = 0, uint32 mode = kWordWrapOnExplicitNewLines) const;
 	/** @overload */
 	int wordWrapText(const Common::U32String &str, int maxWidth, Common::Array<Common::U32String> &lines, int initWidth = 0, uint32 mode = kWordWrapOnExplicitNewLines) const;
+
+protected:
+	/**
+	 * Allow wordWrapText() to memoize its results.
+	 *
+	 * GUI code tends to re-wrap the same unchanged strings on every redraw,
+	 * so caching the resulting lines avoids measuring them over and over.
+	 * Only fonts whose character widths and kerning never change after they
+	 * have been loaded may enable this.
+	 */
+	void setWordWrapCacheEnabled(bool enable);
+
+	/**
+	 * Discard all memoized wordWrapText() results. Needs to be called by
+	 * fonts using the cache whenever their metrics change.
+	 */
+	void invalidateWordWrapCache();
+
+private:
+	struct WordWrapCache;
+
+	template<class StringType, class CacheType>
+	int wordWrapTextCached(CacheType &cache, const StringType &str, int maxWidth, Common::Array<StringType> &lines, int initWidth, uint32 mode) const;
+
+	bool _wordWrapCacheEnabled;
+	mutable Common::ScopedPtr<WordWrapCache> _wordWrapCache;
 };
 /** @} */
 } // End of namespace Graphics
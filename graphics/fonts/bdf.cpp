@@ -31,6 +31,7 @@ namespace Graphics {
 
 BdfFont::BdfFont(const BdfFontData &data, DisposeAfterUse::Flag dispose)
 	: _data(data), _dispose(dispose) {
+	setWordWrapCacheEnabled(true);
 }
 
 BdfFont::~BdfFont() {
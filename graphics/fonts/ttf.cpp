@@ -184,6 +184,11 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	// Kerning offsets looked up through FreeType, keyed by the glyph pair
+	// (left slot in the high 16 bits, right slot in the low 16 bits).
+	typedef Common::HashMap<uint32, int> KerningCache;
+	mutable KerningCache _kerningCache;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -249,6 +254,8 @@ bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode siz
 bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold, bool italic,
 				   int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
 	_initialized = false;
+	// Lines wrapped with a previously loaded face do not apply to this one
+	invalidateWordWrapCache();
 
 	if (!g_ttf.isInitialized())
 		return false;
@@ -409,6 +416,8 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 		return false;
 	} else {
 		_initialized = true;
+		// Glyph metrics are fixed once the face is loaded
+		setWordWrapCacheEnabled(true);
 		// At this point we get ownership of _ttfFile
 		return true;
 	}
@@ -588,9 +597,24 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!leftGlyph || !rightGlyph)
 		return 0;
 
+	// Text layout queries the same pairs over and over, so avoid going
+	// through FreeType each time. TrueType glyph indices are 16 bit.
+	const bool cacheable = leftGlyph <= 0xFFFF && rightGlyph <= 0xFFFF;
+	const uint32 pair = (leftGlyph << 16) | rightGlyph;
+	if (cacheable) {
+		KerningCache::const_iterator kerningEntry = _kerningCache.find(pair);
+		if (kerningEntry != _kerningCache.end())
+			return kerningEntry->_value;
+	}
+
 	FT_Vector kerningVector;
 	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+	const int offset = kerningVector.x / 64;
+
+	if (cacheable)
+		_kerningCache[pair] = offset;
+
+	return offset;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
@@ -632,6 +656,24 @@ static void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos,
 					dstFormat.colorToARGB(*rDst, dA, dR, dG, dB);
 				}
 
+				if (dA == 255) {
+					// Opaque destination, which is the common case. The
+					// general blend below reduces to a plain linear
+					// interpolation, as the output alpha is exactly 1.
+					// Skipping its divisions gives the same results.
+					const double sAn = (double)sA / 255.0;
+					const double iAn = 1.0 - sAn;
+					dR = static_cast<uint8>(sR * sAn + dR * iAn);
+					dG = static_cast<uint8>(sG * sAn + dG * iAn);
+					dB = static_cast<uint8>(sB * sAn + dB * iAn);
+
+					*rDst = dstFormat.ARGBToColor(255, dR, dG, dB);
+
+					++rDst;
+					++src;
+					continue;
+				}
+
 				double sAn = (double)sA / 255.0;
 				double dAn = (double)dA / 255.0;
 				double oAn = sAn + dAn * (1.0 - sAn);
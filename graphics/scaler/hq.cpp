@@ -22,6 +22,10 @@
 #include "graphics/scaler.h"
 #include "graphics/scaler/intern.h"
 
+// The neighbourhood pattern computation is vectorized where an instruction set
+// is available
+#include "common/simd.h"
+
 // RGB-to-YUV lookup table
 
 #ifdef USE_NASM
@@ -193,6 +197,100 @@ static inline uint32 ConvertYUV(uint32 x, const uint32 *RGBtoYUV) {
 	return RGBtoYUV[r | g | b];
 }
 
+#ifdef SCUMMVM_SIMD
+/*
+ * Vectorized computation of the HQ neighbourhood pattern. This is equivalent
+ * to running diffYUV() on each of the eight neighbours of w5, but handles
+ * four neighbours per instruction. Bit n of the result is set when the n-th
+ * entry of neighbours[] (w1, w2, w3, w4, w6, w7, w8, w9) differs from w5 both
+ * in value and in YUV space, exactly like the scalar code.
+ */
+#if defined(SCUMMVM_SIMD_SSE2)
+
+static inline __m128i diffYUV_SSE2(__m128i yuv5, __m128i yuv) {
+	const __m128i Ymask = _mm_set1_epi32(0x00FF0000);
+	const __m128i Umask = _mm_set1_epi32(0x0000FF00);
+	const __m128i Vmask = _mm_set1_epi32(0x000000FF);
+	const __m128i trY   = _mm_set1_epi32(0x00300000);
+	const __m128i trU   = _mm_set1_epi32(0x00000700);
+	const __m128i trV   = _mm_set1_epi32(0x00000006);
+
+	__m128i diff, mask, result;
+
+	// SSE2 has no 32 bit abs, so use the same sign mask trick as diffYUV()
+	diff = _mm_sub_epi32(_mm_and_si128(yuv5, Umask), _mm_and_si128(yuv, Umask));
+	mask = _mm_srai_epi32(diff, 31);
+	diff = _mm_sub_epi32(_mm_xor_si128(diff, mask), mask);
+	result = _mm_cmpgt_epi32(diff, trU);
+
+	diff = _mm_sub_epi32(_mm_and_si128(yuv5, Vmask), _mm_and_si128(yuv, Vmask));
+	mask = _mm_srai_epi32(diff, 31);
+	diff = _mm_sub_epi32(_mm_xor_si128(diff, mask), mask);
+	result = _mm_or_si128(result, _mm_cmpgt_epi32(diff, trV));
+
+	diff = _mm_sub_epi32(_mm_and_si128(yuv5, Ymask), _mm_and_si128(yuv, Ymask));
+	mask = _mm_srai_epi32(diff, 31);
+	diff = _mm_sub_epi32(_mm_xor_si128(diff, mask), mask);
+	return _mm_or_si128(result, _mm_cmpgt_epi32(diff, trY));
+}
+
+static inline int computePattern(int w5, uint32 yuv5, const int *neighbours, const uint32 *yuvNeighbours) {
+	const __m128i w5_4 = _mm_set1_epi32(w5);
+	const __m128i yuv5_4 = _mm_set1_epi32(yuv5);
+
+	const __m128i wLo = _mm_loadu_si128((const __m128i *)neighbours);
+	const __m128i wHi = _mm_loadu_si128((const __m128i *)(neighbours + 4));
+	const __m128i yuvLo = _mm_loadu_si128((const __m128i *)yuvNeighbours);
+	const __m128i yuvHi = _mm_loadu_si128((const __m128i *)(yuvNeighbours + 4));
+
+	const __m128i lo = _mm_andnot_si128(_mm_cmpeq_epi32(w5_4, wLo), diffYUV_SSE2(yuv5_4, yuvLo));
+	const __m128i hi = _mm_andnot_si128(_mm_cmpeq_epi32(w5_4, wHi), diffYUV_SSE2(yuv5_4, yuvHi));
+
+	return _mm_movemask_ps(_mm_castsi128_ps(lo)) | (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4);
+}
+
+#elif defined(SCUMMVM_SIMD_NEON)
+
+static inline uint32x4_t diffYUV_NEON(int32x4_t yuv5, int32x4_t yuv) {
+	const int32x4_t Ymask = vdupq_n_s32(0x00FF0000);
+	const int32x4_t Umask = vdupq_n_s32(0x0000FF00);
+	const int32x4_t Vmask = vdupq_n_s32(0x000000FF);
+	const int32x4_t trY   = vdupq_n_s32(0x00300000);
+	const int32x4_t trU   = vdupq_n_s32(0x00000700);
+	const int32x4_t trV   = vdupq_n_s32(0x00000006);
+
+	uint32x4_t result;
+
+	result = vcgtq_s32(vabdq_s32(vandq_s32(yuv5, Umask), vandq_s32(yuv, Umask)), trU);
+	result = vorrq_u32(result, vcgtq_s32(vabdq_s32(vandq_s32(yuv5, Vmask), vandq_s32(yuv, Vmask)), trV));
+	return vorrq_u32(result, vcgtq_s32(vabdq_s32(vandq_s32(yuv5, Ymask), vandq_s32(yuv, Ymask)), trY));
+}
+
+static inline int computePattern(int w5, uint32 yuv5, const int *neighbours, const uint32 *yuvNeighbours) {
+	static const uint32 bitsLo[4] = { 0x01, 0x02, 0x04, 0x08 };
+	static const uint32 bitsHi[4] = { 0x10, 0x20, 0x40, 0x80 };
+
+	const int32x4_t w5_4 = vdupq_n_s32(w5);
+	const int32x4_t yuv5_4 = vreinterpretq_s32_u32(vdupq_n_u32(yuv5));
+
+	const int32x4_t wLo = vld1q_s32(neighbours);
+	const int32x4_t wHi = vld1q_s32(neighbours + 4);
+	const int32x4_t yuvLo = vreinterpretq_s32_u32(vld1q_u32(yuvNeighbours));
+	const int32x4_t yuvHi = vreinterpretq_s32_u32(vld1q_u32(yuvNeighbours + 4));
+
+	const uint32x4_t lo = vbicq_u32(diffYUV_NEON(yuv5_4, yuvLo), vceqq_s32(w5_4, wLo));
+	const uint32x4_t hi = vbicq_u32(diffYUV_NEON(yuv5_4, yuvHi), vceqq_s32(w5_4, wHi));
+
+	// Turn the lane masks into pattern bits and fold them together
+	const uint32x4_t bits = vorrq_u32(vandq_u32(lo, vld1q_u32(bitsLo)), vandq_u32(hi, vld1q_u32(bitsHi)));
+	uint32x2_t sum = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+	sum = vpadd_u32(sum, sum);
+	return (int)vget_lane_u32(sum, 0);
+}
+
+#endif
+#endif // SCUMMVM_SIMD
+
 /*
  * The HQ2x high quality 2x graphics filter.
  * Original author Maxim Stepin (see http://www.hiend3d.com/hq2x.html).
@@ -238,6 +336,11 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+#ifdef SCUMMVM_SIMD
+			const int neighbours[8] = { w1, w2, w3, w4, w6, w7, w8, w9 };
+			const uint32 yuvNeighbours[8] = { YUV(1), YUV(2), YUV(3), YUV(4), YUV(6), YUV(7), YUV(8), YUV(9) };
+			const int pattern = computePattern(w5, YUV(5), neighbours, yuvNeighbours);
+#else
 			int pattern = 0;
 			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
@@ -248,6 +351,7 @@ static void HQ2x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
 			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
 			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#endif
 
 			switch (pattern) {
 			case 0:
@@ -2156,6 +2260,11 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+#ifdef SCUMMVM_SIMD
+			const int neighbours[8] = { w1, w2, w3, w4, w6, w7, w8, w9 };
+			const uint32 yuvNeighbours[8] = { YUV(1), YUV(2), YUV(3), YUV(4), YUV(6), YUV(7), YUV(8), YUV(9) };
+			const int pattern = computePattern(w5, YUV(5), neighbours, yuvNeighbours);
+#else
 			int pattern = 0;
 			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
@@ -2166,6 +2275,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
 			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
 			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#endif
 
 			switch (pattern) {
 			case 0:
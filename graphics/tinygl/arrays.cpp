@@ -245,26 +245,56 @@ void GLContext::glopDrawElements(GLParam *p) {
 	GLParam array_element[2];
 	void *indices;
 	GLParam begin[2];
+	int count = p[2].i;
 
 	indices = (char *)p[4].p;
 	begin[1].i = p[1].i;
 
+	// Indexed meshes reference most of their vertices several times. Each
+	// index is transformed and lit the first time it appears in the draw only,
+	// its other occurrences copy the resulting vertex. The last element is
+	// always processed, so that the current color, normal and texture
+	// coordinates end up the same as without the cache.
+	bool useCache = (client_states & VERTEX_ARRAY) != 0;
+	if (useCache && ++vertex_cache_stamp == 0) {
+		for (uint i = 0; i < vertex_cache.size(); i++)
+			vertex_cache[i].stamp = 0;
+		vertex_cache_stamp = 1;
+	}
+
 	glopBegin(begin);
-	for (int i = 0; i < p[2].i; i++) {
+	for (int i = 0; i < count; i++) {
+		int idx;
 		switch (p[3].i) {
 		case TGL_UNSIGNED_BYTE:
-			array_element[1].i = ((TGLbyte *)indices)[i];
+			idx = ((TGLubyte *)indices)[i];
 			break;
 		case TGL_UNSIGNED_SHORT:
-			array_element[1].i = ((TGLshort *)indices)[i];
+			idx = ((TGLushort *)indices)[i];
 			break;
 		case TGL_UNSIGNED_INT:
-			array_element[1].i = ((TGLint *)indices)[i];
+			idx = ((TGLuint *)indices)[i];
 			break;
 		default:
 			assert(0);
+			idx = 0;
 			break;
 		}
+
+		if (useCache) {
+			if ((uint)idx >= vertex_cache.size())
+				vertex_cache.resize(idx + 1);
+			VertexCacheEntry &entry = vertex_cache[idx];
+			if (entry.stamp == vertex_cache_stamp && i + 1 < count) {
+				GLVertex *v = gl_new_vertex();
+				*v = vertex[entry.vertex];
+				continue;
+			}
+			entry.stamp = vertex_cache_stamp;
+			entry.vertex = vertex_n;
+		}
+
+		array_element[1].i = idx;
 		glopArrayElement(array_element);
 	}
 	glopEnd(nullptr);
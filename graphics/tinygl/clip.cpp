@@ -277,12 +277,40 @@ void GLContext::gl_draw_triangle(GLVertex *p0, GLVertex *p1, GLVertex *p2) {
 		}
 	} else {
 		c_and = cc[0] & cc[1] & cc[2];
-		if (c_and == 0) {
+		if (c_and == 0 && !gl_is_triangle_culled(p0, p1, p2)) {
 			gl_draw_triangle_clip(p0, p1, p2, 0);
 		}
 	}
 }
 
+// Culls triangles that need clipping before they are clipped, as the parts
+// left after clipping would be culled one by one otherwise. With all the
+// vertices in front of the eye, the orientation of the projected triangle is
+// the sign of the determinant of the X, Y and W clip coordinates.
+bool GLContext::gl_is_triangle_culled(GLVertex *p0, GLVertex *p1, GLVertex *p2) {
+	if (!cull_face_enabled)
+		return false;
+	if (current_cull_face != TGL_BACK && current_cull_face != TGL_FRONT)
+		return true;
+	if (p0->pc.W <= 0 || p1->pc.W <= 0 || p2->pc.W <= 0)
+		return false;
+
+	const Vector4 &a = p0->pc, &b = p1->pc, &d = p2->pc;
+	float det = a.X * (b.Y * d.W - d.Y * b.W) -
+				b.X * (a.Y * d.W - d.Y * a.W) +
+				d.X * (a.Y * b.W - b.Y * a.W);
+	float norm = det * viewport.scale.X * viewport.scale.Y;
+	if (norm == 0)
+		return false;
+
+	int front = norm < 0.0;
+	front = front ^ current_front_face;
+	if (current_cull_face == TGL_BACK)
+		return front == 0;
+	else
+		return front != 0;
+}
+
 void GLContext::gl_draw_triangle_clip(GLVertex *p0, GLVertex *p1, GLVertex *p2, int clip_bit) {
 	int co, c_and, co1, cc[3], edge_flag_tmp, clip_mask;
 	GLVertex tmp1, tmp2, *q[3];
@@ -376,6 +404,36 @@ void GLContext::gl_draw_triangle_select(GLContext *c, GLVertex *p0, GLVertex *p1
 int count_triangles, count_triangles_textured, count_pixels;
 #endif
 
+// Picks the mipmap level that comes closest to one texel per pixel, from the
+// ratio between the areas the triangle covers in the texture and on screen.
+// The level is chosen per triangle, so mipmap filters blending two levels
+// behave like their nearest level counterpart.
+static const TexelBuffer *selectTextureLevel(const GLTexture *texture, int textureSize,
+                                             const ZBufferPoint *p0, const ZBufferPoint *p1, const ZBufferPoint *p2) {
+	const TexelBuffer *pixmap = texture->images[0].pixmap;
+	if (!texture->images[1].pixmap)
+		return pixmap;
+
+	float screenArea = fabs((float)(p1->x - p0->x) * (p2->y - p0->y) - (float)(p2->x - p0->x) * (p1->y - p0->y));
+	if (screenArea == 0.0f)
+		return pixmap;
+
+	// Texture coordinates span textureSize units per texture, in fixed point
+	float textureUnit = (float)(textureSize << ZB_POINT_ST_FRAC_BITS);
+	float textureArea = fabs(((float)p1->s - p0->s) * ((float)p2->t - p0->t) - ((float)p2->s - p0->s) * ((float)p1->t - p0->t));
+	textureArea *= pixmap->getWidth() * pixmap->getHeight() / (textureUnit * textureUnit);
+
+	// Each level divides the texel area by 4; switch level half way in log scale
+	float ratio = textureArea / screenArea;
+	float threshold = 2.0f;
+	int level = 0;
+	while (ratio >= threshold && level + 1 < MAX_TEXTURE_LEVELS && texture->images[level + 1].pixmap) {
+		level++;
+		threshold *= 4.0f;
+	}
+	return texture->images[level].pixmap;
+}
+
 void GLContext::gl_draw_triangle_fill(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2) {
 #ifdef TINYGL_PROFILE
 	{
@@ -400,7 +458,8 @@ void GLContext::gl_draw_triangle_fill(GLContext *c, GLVertex *p0, GLVertex *p1,
 #ifdef TINYGL_PROFILE
 		count_triangles_textured++;
 #endif
-		c->fb->setTexture(c->current_texture->images[0].pixmap, c->texture_wrap_s, c->texture_wrap_t);
+		const TexelBuffer *pixmap = selectTextureLevel(c->current_texture, c->_textureSize, &p0->zp, &p1->zp, &p2->zp);
+		c->fb->setTexture(pixmap, c->texture_wrap_s, c->texture_wrap_t);
 		if (c->current_shade_model == TGL_SMOOTH) {
 			c->fb->fillTriangleTextureMappingPerspectiveSmooth(&p0->zp, &p1->zp, &p2->zp);
 		} else {
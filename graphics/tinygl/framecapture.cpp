@@ -0,0 +1,700 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/tinygl/framecapture.h"
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+
+#include "common/endian.h"
+
+namespace TinyGL {
+
+// Frame captures are a header followed by a list of tagged records. Textures
+// and blit images are written once, before the first draw call using them,
+// and are then referred to by their index in the capture.
+enum {
+	kCaptureVersion = 1,
+
+	kTagHeader = MKTAG('T', 'G', 'L', 'F'),
+	kTagTexture = MKTAG('T', 'E', 'X', 'T'),
+	kTagBlitImage = MKTAG('B', 'I', 'M', 'G'),
+	kTagClear = MKTAG('C', 'L', 'E', 'R'),
+	kTagRasterization = MKTAG('R', 'A', 'S', 'T'),
+	kTagBlitting = MKTAG('B', 'L', 'I', 'T'),
+	kTagEnd = MKTAG('E', 'N', 'D', ' ')
+};
+
+// Texture record flags
+enum {
+	kTextureFiltered = 1 << 0,
+	kTextureMipmapped = 1 << 1
+};
+
+// Serialized size of a GLVertex, see writeVertex()
+static const int kVertexSize = 4 + 3 * 4 + 5 * 4 * 4 + 4 + 9 * 4 + 2 * 4;
+// Serialized sizes of the draw call records without their tag, and without
+// the vertices for rasterization, see writeRasterization() and writeBlitting()
+static const int kRasterizationSize = 4 + 2 + 3 * 4 + 4 + 1 + 2 * 4 + 1 + 4 * 4 + 1 + 5 * 4 + 6 * 4 + 1 + 2 * 4 + 1 + 9 * 4 + 4;
+static const int kBlittingSize = 4 + 1 + 2 * 8 + 3 * 4 + 4 * 4 + 2 + 1 + 2 * 4 + 1 + 3 * 4;
+
+static const gl_draw_triangle_func drawTriangleFuncs[] = {
+	GLContext::gl_draw_triangle_point,
+	GLContext::gl_draw_triangle_line,
+	GLContext::gl_draw_triangle_fill,
+	GLContext::gl_draw_triangle_select
+};
+
+static byte getDrawTriangleFuncIndex(gl_draw_triangle_func func) {
+	for (byte i = 0; i < ARRAYSIZE(drawTriangleFuncs); i++) {
+		if (drawTriangleFuncs[i] == func)
+			return i;
+	}
+	return 0;
+}
+
+static void writeVector(Common::WriteStream &stream, const float *v, int count) {
+	for (int i = 0; i < count; i++)
+		stream.writeFloatLE(v[i]);
+}
+
+static void readVector(Common::ReadStream &stream, float *v, int count) {
+	for (int i = 0; i < count; i++)
+		v[i] = stream.readFloatLE();
+}
+
+static void writeVertex(Common::WriteStream &stream, const GLVertex &v) {
+	stream.writeSint32LE(v.edge_flag);
+	writeVector(stream, v.normal._v, 3);
+	writeVector(stream, v.coord._v, 4);
+	writeVector(stream, v.tex_coord._v, 4);
+	writeVector(stream, v.color._v, 4);
+	writeVector(stream, v.ec._v, 4);
+	writeVector(stream, v.pc._v, 4);
+	stream.writeSint32LE(v.clip_code);
+	stream.writeSint32LE(v.zp.x);
+	stream.writeSint32LE(v.zp.y);
+	stream.writeSint32LE(v.zp.z);
+	stream.writeSint32LE(v.zp.s);
+	stream.writeSint32LE(v.zp.t);
+	stream.writeSint32LE(v.zp.r);
+	stream.writeSint32LE(v.zp.g);
+	stream.writeSint32LE(v.zp.b);
+	stream.writeSint32LE(v.zp.a);
+	stream.writeFloatLE(v.zp.sz);
+	stream.writeFloatLE(v.zp.tz);
+}
+
+static void readVertex(Common::ReadStream &stream, GLVertex &v) {
+	v.edge_flag = stream.readSint32LE();
+	readVector(stream, v.normal._v, 3);
+	readVector(stream, v.coord._v, 4);
+	readVector(stream, v.tex_coord._v, 4);
+	readVector(stream, v.color._v, 4);
+	readVector(stream, v.ec._v, 4);
+	readVector(stream, v.pc._v, 4);
+	v.clip_code = stream.readSint32LE();
+	v.zp.x = stream.readSint32LE();
+	v.zp.y = stream.readSint32LE();
+	v.zp.z = stream.readSint32LE();
+	v.zp.s = stream.readSint32LE();
+	v.zp.t = stream.readSint32LE();
+	v.zp.r = stream.readSint32LE();
+	v.zp.g = stream.readSint32LE();
+	v.zp.b = stream.readSint32LE();
+	v.zp.a = stream.readSint32LE();
+	v.zp.sz = stream.readFloatLE();
+	v.zp.tz = stream.readFloatLE();
+}
+
+static void writeRect(Common::WriteStream &stream, const Common::Rect &rect) {
+	stream.writeSint16LE(rect.left);
+	stream.writeSint16LE(rect.top);
+	stream.writeSint16LE(rect.right);
+	stream.writeSint16LE(rect.bottom);
+}
+
+static void readRect(Common::ReadStream &stream, Common::Rect &rect) {
+	rect.left = stream.readSint16LE();
+	rect.top = stream.readSint16LE();
+	rect.right = stream.readSint16LE();
+	rect.bottom = stream.readSint16LE();
+}
+
+static bool hasRemainingData(Common::SeekableReadStream &stream, int64 size) {
+	return !stream.err() && !stream.eos() && stream.size() - stream.pos() >= size;
+}
+
+static bool isFinite(float value) {
+	// Infinities and NaNs give NaN, which is not equal to anything
+	return value - value == 0.0f;
+}
+
+// Returns whether RasterizationDrawCall::execute() only reads vertices of the
+// draw call for the given primitive type and vertex count
+static bool isValidVertexCount(int beginType, int vertexCount) {
+	switch (beginType) {
+	case TGL_POINTS:
+	case TGL_LINES:
+	case TGL_LINE_LOOP:
+	case TGL_LINE_STRIP:
+	case TGL_TRIANGLE_STRIP:
+	case TGL_QUAD_STRIP:
+	case TGL_POLYGON:
+		return true;
+	case TGL_TRIANGLES:
+		return vertexCount % 3 == 0;
+	case TGL_TRIANGLE_FAN:
+		return vertexCount % 2 == 1;
+	case TGL_QUADS:
+		return vertexCount % 4 == 0;
+	default:
+		return false;
+	}
+}
+
+// Returns whether the vertex can be rasterized without writing outside of
+// the frame buffer. Vertices which are not clipped are drawn at their
+// captured screen coordinates, and the clipped ones are mapped to the
+// captured viewport, which is checked separately.
+static bool isValidVertex(const GLVertex &v, int width, int height) {
+	for (int i = 0; i < 4; i++) {
+		if (!isFinite(v.pc._v[i]))
+			return false;
+	}
+	if (v.clip_code != gl_clipcode(v.pc.X, v.pc.Y, v.pc.Z, v.pc.W))
+		return false;
+	return v.clip_code != 0 || (v.zp.x >= 0 && v.zp.x < width && v.zp.y >= 0 && v.zp.y < height);
+}
+
+// Returns whether the viewport, as set up by GLContext::gl_eval_viewport(),
+// lies within the frame buffer
+static bool isValidViewport(const float *translation, const float *scaling, int width, int height) {
+	for (int i = 0; i < 3; i++) {
+		if (!isFinite(translation[i]) || !isFinite(scaling[i]))
+			return false;
+	}
+	const float halfWidth = fabs(scaling[0]);
+	const float halfHeight = fabs(scaling[1]);
+	return translation[0] - halfWidth >= 0.0f && translation[0] + halfWidth < width &&
+	       translation[1] - halfHeight >= 0.0f && translation[1] + halfHeight < height;
+}
+
+void captureNextFrame(Common::WriteStream *stream) {
+	gl_get_context()->_frameCaptureStream = stream;
+}
+
+bool replayFrame(Common::SeekableReadStream *stream) {
+	return FrameCapture::readFrame(*stream);
+}
+
+FrameCapture::FrameCapture(Common::WriteStream *writeStream, Common::SeekableReadStream *readStream) :
+	_writeStream(writeStream), _readStream(readStream) {
+}
+
+void FrameCapture::writeFrame(Common::WriteStream &stream, const Common::List<DrawCall *> &drawCalls) {
+	GLContext *c = gl_get_context();
+	FrameCapture capture(&stream, nullptr);
+
+	stream.writeUint32BE(kTagHeader);
+	stream.writeUint32LE(kCaptureVersion);
+	stream.writeUint16LE(c->fb->getPixelBufferWidth());
+	stream.writeUint16LE(c->fb->getPixelBufferHeight());
+	stream.writeUint16LE(c->_textureSize);
+
+	for (Common::List<DrawCall *>::const_iterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		switch ((*it)->getType()) {
+		case DrawCall::DrawCall_Clear:
+			capture.writeClear(*(const ClearBufferDrawCall *)*it);
+			break;
+		case DrawCall::DrawCall_Rasterization:
+			capture.writeRasterization(*(const RasterizationDrawCall *)*it);
+			break;
+		case DrawCall::DrawCall_Blitting:
+			capture.writeBlitting(*(const BlittingDrawCall *)*it);
+			break;
+		default:
+			break;
+		}
+	}
+
+	stream.writeUint32BE(kTagEnd);
+	if (stream.err())
+		warning("TinyGL: Failed to write the frame capture");
+}
+
+bool FrameCapture::readFrame(Common::SeekableReadStream &stream) {
+	GLContext *c = gl_get_context();
+
+	if (stream.readUint32BE() != kTagHeader || stream.readUint32LE() != kCaptureVersion)
+		return false;
+
+	int width = stream.readUint16LE();
+	int height = stream.readUint16LE();
+	int textureSize = stream.readUint16LE();
+	if (width != c->fb->getPixelBufferWidth() || height != c->fb->getPixelBufferHeight() ||
+	    textureSize != c->_textureSize) {
+		warning("TinyGL: Frame capture was made with a %dx%d screen and %d texture size", width, height, textureSize);
+		return false;
+	}
+
+	// The textures of the previously replayed frame are no longer referenced
+	// by the draw calls compared against, so they can be disposed of now.
+	if (!c->_replayTextures.empty()) {
+		tglDeleteTextures(c->_replayTextures.size(), c->_replayTextures.begin());
+		c->_replayTextures.clear();
+	}
+
+	FrameCapture capture(nullptr, &stream);
+	bool result = true;
+	while (result) {
+		if (!hasRemainingData(stream, 4)) {
+			result = false;
+			break;
+		}
+
+		uint32 tag = stream.readUint32BE();
+		if (tag == kTagEnd)
+			break;
+
+		switch (tag) {
+		case kTagTexture:
+			result = capture.readTexture();
+			break;
+		case kTagBlitImage:
+			result = capture.readBlitImage();
+			break;
+		case kTagClear:
+			result = capture.readClear();
+			break;
+		case kTagRasterization:
+			result = capture.readRasterization();
+			break;
+		case kTagBlitting:
+			result = capture.readBlitting();
+			break;
+		default:
+			result = false;
+			break;
+		}
+	}
+
+	// Draw calls hold their own reference to the blit images
+	for (uint i = 0; i < capture._readBlitImages.size(); i++)
+		tglDeleteBlitImage(capture._readBlitImages[i]);
+
+	return result;
+}
+
+void FrameCapture::writeClear(const ClearBufferDrawCall &call) {
+	_writeStream->writeUint32BE(kTagClear);
+	_writeStream->writeByte(call._clearZBuffer);
+	_writeStream->writeByte(call._clearColorBuffer);
+	_writeStream->writeByte(call._clearStencilBuffer);
+	_writeStream->writeSint32LE(call._zValue);
+	_writeStream->writeSint32LE(call._rValue);
+	_writeStream->writeSint32LE(call._gValue);
+	_writeStream->writeSint32LE(call._bValue);
+	_writeStream->writeSint32LE(call._stencilValue);
+}
+
+bool FrameCapture::readClear() {
+	if (!hasRemainingData(*_readStream, 3 + 5 * 4))
+		return false;
+
+	bool clearZBuffer = _readStream->readByte();
+	bool clearColorBuffer = _readStream->readByte();
+	bool clearStencilBuffer = _readStream->readByte();
+	int zValue = _readStream->readSint32LE();
+	int rValue = _readStream->readSint32LE();
+	int gValue = _readStream->readSint32LE();
+	int bValue = _readStream->readSint32LE();
+	int stencilValue = _readStream->readSint32LE();
+
+	gl_get_context()->issueDrawCall(new ClearBufferDrawCall(clearZBuffer, zValue, clearColorBuffer, rValue, gValue, bValue, clearStencilBuffer, stencilValue));
+	return true;
+}
+
+int FrameCapture::writeTexture(const GLTexture *texture) {
+	const TexelBuffer *pixmap = texture->images[0].pixmap;
+	if (!pixmap)
+		return -1;
+
+	for (uint i = 0; i < _writtenTextures.size(); i++) {
+		if (_writtenTextures[i] == texture)
+			return i;
+	}
+
+	_writeStream->writeUint32BE(kTagTexture);
+	_writeStream->writeUint16LE(pixmap->getWidth());
+	_writeStream->writeUint16LE(pixmap->getHeight());
+	byte flags = 0;
+	if (pixmap->isFiltered())
+		flags |= kTextureFiltered;
+	if (texture->images[1].pixmap)
+		flags |= kTextureMipmapped;
+	_writeStream->writeByte(flags);
+	for (uint y = 0; y < pixmap->getHeight(); y++) {
+		for (uint x = 0; x < pixmap->getWidth(); x++) {
+			uint8 a, r, g, b;
+			pixmap->getTexelAt(x, y, a, r, g, b);
+			_writeStream->writeByte(r);
+			_writeStream->writeByte(g);
+			_writeStream->writeByte(b);
+			_writeStream->writeByte(a);
+		}
+	}
+
+	_writtenTextures.push_back(texture);
+	return _writtenTextures.size() - 1;
+}
+
+bool FrameCapture::readTexture() {
+	if (!hasRemainingData(*_readStream, 5))
+		return false;
+
+	int width = _readStream->readUint16LE();
+	int height = _readStream->readUint16LE();
+	byte flags = _readStream->readByte();
+	if (width == 0 || height == 0 || !hasRemainingData(*_readStream, (int64)width * height * 4))
+		return false;
+
+	int size = width * height * 4;
+
+	byte *pixels = new byte[size];
+	_readStream->read(pixels, size);
+
+	// The filter and the bound texture are context state, which the texture
+	// upload must not leave changed.
+	GLContext *c = gl_get_context();
+	GLTexture *boundTexture = c->current_texture;
+	int minFilter = c->texture_min_filter;
+	int magFilter = c->texture_mag_filter;
+
+	TGLuint handle;
+	tglGenTextures(1, &handle);
+	tglBindTexture(TGL_TEXTURE_2D, handle);
+	if (flags & kTextureFiltered) {
+		c->texture_mag_filter = TGL_LINEAR;
+		c->texture_min_filter = (flags & kTextureMipmapped) ? TGL_LINEAR_MIPMAP_NEAREST : TGL_LINEAR;
+	} else {
+		c->texture_mag_filter = TGL_NEAREST;
+		c->texture_min_filter = (flags & kTextureMipmapped) ? TGL_NEAREST_MIPMAP_NEAREST : TGL_NEAREST;
+	}
+	tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, width, height, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+	delete[] pixels;
+
+	_readTextures.push_back(c->current_texture);
+	c->_replayTextures.push_back(handle);
+
+	c->current_texture = boundTexture;
+	c->texture_min_filter = minFilter;
+	c->texture_mag_filter = magFilter;
+	return true;
+}
+
+int FrameCapture::writeBlitImage(BlitImage *image) {
+	for (uint i = 0; i < _writtenBlitImages.size(); i++) {
+		if (_writtenBlitImages[i] == image)
+			return i;
+	}
+
+	// Blit images are converted to 32 bits when uploaded, so this only fails
+	// for images which never were
+	const Graphics::Surface &surface = Internal::tglGetBlitImageSurface(image);
+	if (surface.format.bytesPerPixel < 2 || !surface.getPixels())
+		return -1;
+
+	_writeStream->writeUint32BE(kTagBlitImage);
+	_writeStream->writeUint16LE(surface.w);
+	_writeStream->writeUint16LE(surface.h);
+	for (int y = 0; y < surface.h; y++) {
+		for (int x = 0; x < surface.w; x++) {
+			uint8 a, r, g, b;
+			surface.format.colorToARGB(surface.getPixel(x, y), a, r, g, b);
+			_writeStream->writeByte(r);
+			_writeStream->writeByte(g);
+			_writeStream->writeByte(b);
+			_writeStream->writeByte(a);
+		}
+	}
+
+	_writtenBlitImages.push_back(image);
+	return _writtenBlitImages.size() - 1;
+}
+
+bool FrameCapture::readBlitImage() {
+	if (!hasRemainingData(*_readStream, 4))
+		return false;
+
+	int width = _readStream->readUint16LE();
+	int height = _readStream->readUint16LE();
+	if (!hasRemainingData(*_readStream, (int64)width * height * 4))
+		return false;
+
+	// Color keying has already been applied to the captured image data
+	Graphics::Surface surface;
+	surface.create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+	for (int y = 0; y < height; y++) {
+		uint32 *dst = (uint32 *)surface.getBasePtr(0, y);
+		for (int x = 0; x < width; x++) {
+			byte r = _readStream->readByte();
+			byte g = _readStream->readByte();
+			byte b = _readStream->readByte();
+			byte a = _readStream->readByte();
+			dst[x] = surface.format.ARGBToColor(a, r, g, b);
+		}
+	}
+
+	BlitImage *image = tglGenBlitImage();
+	tglUploadBlitImage(image, surface, 0, false);
+	surface.free();
+
+	_readBlitImages.push_back(image);
+	return true;
+}
+
+void FrameCapture::writeRasterization(const RasterizationDrawCall &call) {
+	const RasterizationDrawCall::RasterizationState &state = call._state;
+	int textureIndex = writeTexture(state.texture);
+
+	_writeStream->writeUint32BE(kTagRasterization);
+	_writeStream->writeSint32LE(textureIndex);
+	_writeStream->writeByte(getDrawTriangleFuncIndex((gl_draw_triangle_func)call._drawTriangleFront));
+	_writeStream->writeByte(getDrawTriangleFuncIndex((gl_draw_triangle_func)call._drawTriangleBack));
+
+	_writeStream->writeSint32LE(state.beginType);
+	_writeStream->writeSint32LE(state.currentFrontFace);
+	_writeStream->writeSint32LE(state.cullFaceEnabled);
+	_writeStream->writeByte(state.colorMaskRed);
+	_writeStream->writeByte(state.colorMaskGreen);
+	_writeStream->writeByte(state.colorMaskBlue);
+	_writeStream->writeByte(state.colorMaskAlpha);
+	_writeStream->writeByte(state.depthTestEnabled);
+	_writeStream->writeSint32LE(state.depthFunction);
+	_writeStream->writeSint32LE(state.depthWriteMask);
+	_writeStream->writeByte(state.texture2DEnabled);
+	_writeStream->writeSint32LE(state.currentShadeModel);
+	_writeStream->writeSint32LE(state.polygonModeBack);
+	_writeStream->writeSint32LE(state.polygonModeFront);
+	_writeStream->writeSint32LE(state.lightingEnabled);
+	_writeStream->writeByte(state.enableBlending);
+	_writeStream->writeSint32LE(state.sfactor);
+	_writeStream->writeSint32LE(state.dfactor);
+	_writeStream->writeSint32LE(state.offsetStates);
+	_writeStream->writeFloatLE(state.offsetFactor);
+	_writeStream->writeFloatLE(state.offsetUnits);
+	writeVector(*_writeStream, state.viewportTranslation, 3);
+	writeVector(*_writeStream, state.viewportScaling, 3);
+	_writeStream->writeByte(state.alphaTestEnabled);
+	_writeStream->writeSint32LE(state.alphaFunc);
+	_writeStream->writeSint32LE(state.alphaRefValue);
+	_writeStream->writeByte(state.stencilTestEnabled);
+	_writeStream->writeSint32LE(state.stencilTestFunc);
+	_writeStream->writeSint32LE(state.stencilValue);
+	_writeStream->writeUint32LE(state.stencilMask);
+	_writeStream->writeUint32LE(state.stencilWriteMask);
+	_writeStream->writeSint32LE(state.stencilSfail);
+	_writeStream->writeSint32LE(state.stencilDpfail);
+	_writeStream->writeSint32LE(state.stencilDppass);
+	_writeStream->writeUint32LE(state.wrapS);
+	_writeStream->writeUint32LE(state.wrapT);
+
+	_writeStream->writeSint32LE(call._vertexCount);
+	for (int i = 0; i < call._vertexCount; i++)
+		writeVertex(*_writeStream, call._vertex[i]);
+}
+
+bool FrameCapture::readRasterization() {
+	if (!hasRemainingData(*_readStream, kRasterizationSize))
+		return false;
+
+	GLContext *c = gl_get_context();
+	RasterizationDrawCall::RasterizationState state = RasterizationDrawCall::captureState();
+
+	int textureIndex = _readStream->readSint32LE();
+	uint drawTriangleFront = _readStream->readByte();
+	uint drawTriangleBack = _readStream->readByte();
+	if (textureIndex >= (int)_readTextures.size() ||
+	    drawTriangleFront >= ARRAYSIZE(drawTriangleFuncs) || drawTriangleBack >= ARRAYSIZE(drawTriangleFuncs))
+		return false;
+	state.texture = textureIndex < 0 ? c->find_texture(0) : _readTextures[textureIndex];
+
+	state.beginType = _readStream->readSint32LE();
+	state.currentFrontFace = _readStream->readSint32LE();
+	state.cullFaceEnabled = _readStream->readSint32LE();
+	state.colorMaskRed = _readStream->readByte();
+	state.colorMaskGreen = _readStream->readByte();
+	state.colorMaskBlue = _readStream->readByte();
+	state.colorMaskAlpha = _readStream->readByte();
+	state.depthTestEnabled = _readStream->readByte();
+	state.depthFunction = _readStream->readSint32LE();
+	state.depthWriteMask = _readStream->readSint32LE();
+	state.texture2DEnabled = _readStream->readByte();
+	state.currentShadeModel = _readStream->readSint32LE();
+	state.polygonModeBack = _readStream->readSint32LE();
+	state.polygonModeFront = _readStream->readSint32LE();
+	state.lightingEnabled = _readStream->readSint32LE();
+	state.enableBlending = _readStream->readByte();
+	state.sfactor = _readStream->readSint32LE();
+	state.dfactor = _readStream->readSint32LE();
+	state.offsetStates = _readStream->readSint32LE();
+	state.offsetFactor = _readStream->readFloatLE();
+	state.offsetUnits = _readStream->readFloatLE();
+	readVector(*_readStream, state.viewportTranslation, 3);
+	readVector(*_readStream, state.viewportScaling, 3);
+	state.alphaTestEnabled = _readStream->readByte();
+	state.alphaFunc = _readStream->readSint32LE();
+	state.alphaRefValue = _readStream->readSint32LE();
+	state.stencilTestEnabled = _readStream->readByte();
+	state.stencilTestFunc = _readStream->readSint32LE();
+	state.stencilValue = _readStream->readSint32LE();
+	state.stencilMask = _readStream->readUint32LE();
+	state.stencilWriteMask = _readStream->readUint32LE();
+	state.stencilSfail = _readStream->readSint32LE();
+	state.stencilDpfail = _readStream->readSint32LE();
+	state.stencilDppass = _readStream->readSint32LE();
+	state.wrapS = _readStream->readUint32LE();
+	state.wrapT = _readStream->readUint32LE();
+
+	const int width = c->fb->getPixelBufferWidth();
+	const int height = c->fb->getPixelBufferHeight();
+	if (!isValidViewport(state.viewportTranslation, state.viewportScaling, width, height))
+		return false;
+
+	int vertexCount = _readStream->readSint32LE();
+	if (vertexCount <= 0 || !isValidVertexCount(state.beginType, vertexCount) ||
+	    !hasRemainingData(*_readStream, (int64)vertexCount * kVertexSize))
+		return false;
+
+	Common::Array<GLVertex> vertices;
+	vertices.resize(vertexCount);
+	for (int i = 0; i < vertexCount; i++) {
+		readVertex(*_readStream, vertices[i]);
+		if (!isValidVertex(vertices[i], width, height))
+			return false;
+	}
+
+	// Draw calls capture the context state when they are created, so the
+	// context is temporarily put in the captured state.
+	RasterizationDrawCall::RasterizationState backupState = RasterizationDrawCall::captureState();
+	GLVertex *prevVertex = c->vertex;
+	int prevVertexCount = c->vertex_cnt;
+	gl_draw_triangle_func prevDrawTriangleFront = c->draw_triangle_front;
+	gl_draw_triangle_func prevDrawTriangleBack = c->draw_triangle_back;
+
+	RasterizationDrawCall::applyState(state);
+	c->vertex = vertices.begin();
+	c->vertex_cnt = vertexCount;
+	c->draw_triangle_front = drawTriangleFuncs[drawTriangleFront];
+	c->draw_triangle_back = drawTriangleFuncs[drawTriangleBack];
+
+	c->issueDrawCall(new RasterizationDrawCall());
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+	c->draw_triangle_front = prevDrawTriangleFront;
+	c->draw_triangle_back = prevDrawTriangleBack;
+	RasterizationDrawCall::applyState(backupState);
+	return true;
+}
+
+void FrameCapture::writeBlitting(const BlittingDrawCall &call) {
+	int imageIndex = writeBlitImage(call._image);
+	if (imageIndex < 0) {
+		warning("TinyGL: Skipping the capture of a blit of an image without pixel data");
+		return;
+	}
+	const BlitTransform &transform = call._transform;
+	const BlittingDrawCall::BlittingState &state = call._blitState;
+
+	_writeStream->writeUint32BE(kTagBlitting);
+	_writeStream->writeUint32LE(imageIndex);
+	_writeStream->writeByte(call._mode);
+
+	writeRect(*_writeStream, transform._sourceRectangle);
+	writeRect(*_writeStream, transform._destinationRectangle);
+	_writeStream->writeSint32LE(transform._rotation);
+	_writeStream->writeSint32LE(transform._originX);
+	_writeStream->writeSint32LE(transform._originY);
+	_writeStream->writeFloatLE(transform._aTint);
+	_writeStream->writeFloatLE(transform._rTint);
+	_writeStream->writeFloatLE(transform._gTint);
+	_writeStream->writeFloatLE(transform._bTint);
+	_writeStream->writeByte(transform._flipHorizontally);
+	_writeStream->writeByte(transform._flipVertically);
+
+	_writeStream->writeByte(state.enableBlending);
+	_writeStream->writeSint32LE(state.sfactor);
+	_writeStream->writeSint32LE(state.dfactor);
+	_writeStream->writeByte(state.alphaTest);
+	_writeStream->writeSint32LE(state.alphaFunc);
+	_writeStream->writeSint32LE(state.alphaRefValue);
+	_writeStream->writeSint32LE(state.depthTestEnabled);
+}
+
+bool FrameCapture::readBlitting() {
+	if (!hasRemainingData(*_readStream, kBlittingSize))
+		return false;
+
+	uint imageIndex = _readStream->readUint32LE();
+	uint mode = _readStream->readByte();
+	if (imageIndex >= _readBlitImages.size() || mode > BlittingDrawCall::BlitMode_ZBuffer)
+		return false;
+
+	BlitTransform transform(0, 0);
+	readRect(*_readStream, transform._sourceRectangle);
+	readRect(*_readStream, transform._destinationRectangle);
+	transform._rotation = _readStream->readSint32LE();
+	transform._originX = _readStream->readSint32LE();
+	transform._originY = _readStream->readSint32LE();
+	transform._aTint = _readStream->readFloatLE();
+	transform._rTint = _readStream->readFloatLE();
+	transform._gTint = _readStream->readFloatLE();
+	transform._bTint = _readStream->readFloatLE();
+	transform._flipHorizontally = _readStream->readByte();
+	transform._flipVertically = _readStream->readByte();
+
+	BlittingDrawCall::BlittingState state;
+	state.enableBlending = _readStream->readByte();
+	state.sfactor = _readStream->readSint32LE();
+	state.dfactor = _readStream->readSint32LE();
+	state.alphaTest = _readStream->readByte();
+	state.alphaFunc = _readStream->readSint32LE();
+	state.alphaRefValue = _readStream->readSint32LE();
+	state.depthTestEnabled = _readStream->readSint32LE();
+	if (_readStream->err() || _readStream->eos())
+		return false;
+
+	// An empty source rectangle stands for the whole image
+	const Graphics::Surface &image = Internal::tglGetBlitImageSurface(_readBlitImages[imageIndex]);
+	const Common::Rect &source = transform._sourceRectangle;
+	if (!source.isValidRect() || (source.isEmpty() ? (source.left != 0 || source.top != 0) :
+	    !Common::Rect(image.w, image.h).contains(source)))
+		return false;
+
+	BlittingDrawCall::BlittingState backupState = BlittingDrawCall::captureState();
+	BlittingDrawCall::applyState(state);
+	gl_get_context()->issueDrawCall(new BlittingDrawCall(_readBlitImages[imageIndex], transform, (BlittingDrawCall::BlittingMode)mode));
+	BlittingDrawCall::applyState(backupState);
+	return true;
+}
+
+} // end of namespace TinyGL
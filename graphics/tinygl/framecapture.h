@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_TINYGL_FRAMECAPTURE_H
+#define GRAPHICS_TINYGL_FRAMECAPTURE_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/stream.h"
+
+namespace TinyGL {
+
+class DrawCall;
+class ClearBufferDrawCall;
+class RasterizationDrawCall;
+class BlittingDrawCall;
+struct BlitImage;
+struct GLTexture;
+
+/**
+ * Serialization of the draw call list of a frame, used to record frames of
+ * real scenes and render them again outside of the engine that produced
+ * them, e.g. to benchmark the rasterizer.
+ */
+class FrameCapture {
+public:
+	static void writeFrame(Common::WriteStream &stream, const Common::List<DrawCall *> &drawCalls);
+	static bool readFrame(Common::SeekableReadStream &stream);
+
+private:
+	FrameCapture(Common::WriteStream *writeStream, Common::SeekableReadStream *readStream);
+
+	void writeClear(const ClearBufferDrawCall &call);
+	void writeRasterization(const RasterizationDrawCall &call);
+	void writeBlitting(const BlittingDrawCall &call);
+	int writeTexture(const GLTexture *texture);
+	int writeBlitImage(BlitImage *image);
+
+	bool readClear();
+	bool readRasterization();
+	bool readBlitting();
+	bool readTexture();
+	bool readBlitImage();
+
+	Common::WriteStream *_writeStream;
+	Common::SeekableReadStream *_readStream;
+
+	Common::Array<const GLTexture *> _writtenTextures;
+	Common::Array<BlitImage *> _writtenBlitImages;
+
+	Common::Array<GLTexture *> _readTextures;
+	Common::Array<BlitImage *> _readBlitImages;
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -78,6 +78,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	// allocate GLVertex array
 	vertex_max = POLYGON_MAX_VERTEX;
 	vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+	vertex_cache_stamp = 0;
 
 	// viewport
 	v = &viewport;
@@ -259,6 +260,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[0].initialize(kDrawCallMemory);
 	_drawCallAllocator[1].initialize(kDrawCallMemory);
 	_debugRectsEnabled = false;
+	_frameCaptureStream = nullptr;
 
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
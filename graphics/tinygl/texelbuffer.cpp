@@ -95,6 +95,10 @@ void NearestTexelBuffer::getARGBAt(
 	_buf.getARGBAt(pixel, a, r, g, b);
 }
 
+void NearestTexelBuffer::getTexelAt(uint x, uint y, uint8 &a, uint8 &r, uint8 &g, uint8 &b) const {
+	_buf.getARGBAt(y * _width + x, a, r, g, b);
+}
+
 // Bilinear: each texture coordinates corresponds to the 4 original image
 // pixels linear interpolation has to work on, so that they are near each
 // other in CPU data cache, and a single actual memory fetch happens. This
@@ -169,6 +173,14 @@ BilinearTexelBuffer::~BilinearTexelBuffer() {
 	delete[] _texels;
 }
 
+void BilinearTexelBuffer::getTexelAt(uint x, uint y, uint8 &a, uint8 &r, uint8 &g, uint8 &b) const {
+	const uint8 *texel = (const uint8 *)(_texels + ((y * _width + x) << PIXEL_PER_TEXEL_SHIFT));
+	a = *(texel + P00_OFFSET + A_OFFSET);
+	r = *(texel + P00_OFFSET + R_OFFSET);
+	g = *(texel + P00_OFFSET + G_OFFSET);
+	b = *(texel + P00_OFFSET + B_OFFSET);
+}
+
 static inline int interpolate(int v00, int v01, int v10, int xf, int yf) {
 	return v00 + (((v01 - v00) * xf + (v10 - v00) * yf) >> ZB_POINT_ST_FRAC_BITS);
 }
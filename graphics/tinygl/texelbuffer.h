@@ -37,6 +37,13 @@ public:
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	uint getWidth() const { return _width; }
+	uint getHeight() const { return _height; }
+
+	// Unfiltered access to the texels the buffer was created from.
+	virtual void getTexelAt(uint x, uint y, uint8 &a, uint8 &r, uint8 &g, uint8 &b) const = 0;
+	virtual bool isFiltered() const = 0;
+
 protected:
 	virtual void getARGBAt(
 		uint pixel,
@@ -52,6 +59,9 @@ public:
 	NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize);
 	~NearestTexelBuffer();
 
+	void getTexelAt(uint x, uint y, uint8 &a, uint8 &r, uint8 &g, uint8 &b) const override;
+	bool isFiltered() const override { return false; }
+
 protected:
 	void getARGBAt(
 		uint pixel,
@@ -68,6 +78,9 @@ public:
 	BilinearTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize);
 	~BilinearTexelBuffer();
 
+	void getTexelAt(uint x, uint y, uint8 &a, uint8 &r, uint8 &g, uint8 &b) const override;
+	bool isFiltered() const override { return true; }
+
 protected:
 	void getARGBAt(
 		uint pixel,
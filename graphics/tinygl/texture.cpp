@@ -109,6 +109,37 @@ void GLContext::glopBindTexture(GLParam *p) {
 	current_texture = t;
 }
 
+// Box filters an image down to half its size, for the next mipmap level.
+static void downsampleImage(const Graphics::PixelBuffer &src, int srcWidth, int srcHeight,
+                            Graphics::PixelBuffer &dst, int dstWidth, int dstHeight) {
+	for (int y = 0; y < dstHeight; y++) {
+		int y0 = MIN(y * 2, srcHeight - 1) * srcWidth;
+		int y1 = MIN(y * 2 + 1, srcHeight - 1) * srcWidth;
+		for (int x = 0; x < dstWidth; x++) {
+			int x0 = MIN(x * 2, srcWidth - 1);
+			int x1 = MIN(x * 2 + 1, srcWidth - 1);
+			uint a = 0, r = 0, g = 0, b = 0;
+			const int offsets[4] = { y0 + x0, y0 + x1, y1 + x0, y1 + x1 };
+			for (int i = 0; i < 4; i++) {
+				uint8 sa, sr, sg, sb;
+				src.getARGBAt(offsets[i], sa, sr, sg, sb);
+				a += sa;
+				r += sr;
+				g += sg;
+				b += sb;
+			}
+			dst.setPixelAt(y * dstWidth + x, (a + 2) / 4, (r + 2) / 4, (g + 2) / 4, (b + 2) / 4);
+		}
+	}
+}
+
+static TexelBuffer *createTexelBuffer(const Graphics::PixelBuffer &buf, int width, int height, int textureSize, bool filtered) {
+	if (filtered)
+		return new BilinearTexelBuffer(buf, width, height, textureSize);
+	else
+		return new NearestTexelBuffer(buf, width, height, textureSize);
+}
+
 void GLContext::glopTexImage2D(GLParam *p) {
 	int target = p[1].i;
 	int level = p[2].i;
@@ -140,6 +171,14 @@ void GLContext::glopTexImage2D(GLParam *p) {
 		delete im->pixmap;
 		im->pixmap = nullptr;
 	}
+	// Mipmaps are generated from the base level, so any previous ones are
+	// now out of date.
+	if (level == 0) {
+		for (int i = 1; i < MAX_TEXTURE_LEVELS; i++) {
+			delete current_texture->images[i].pixmap;
+			current_texture->images[i].pixmap = nullptr;
+		}
+	}
 	if (pixels) {
 		uint filter;
 		Graphics::PixelFormat pf;
@@ -174,24 +213,60 @@ void GLContext::glopTexImage2D(GLParam *p) {
 			filter = texture_mag_filter;
 		else
 			filter = texture_min_filter;
+		bool filtered;
 		switch (filter) {
 		case TGL_LINEAR_MIPMAP_NEAREST:
 		case TGL_LINEAR_MIPMAP_LINEAR:
 		case TGL_LINEAR:
-			im->pixmap = new BilinearTexelBuffer(
-				srcInternal,
-				width, height,
-				_textureSize
-			);
+			filtered = true;
 			break;
 		default:
-			im->pixmap = new NearestTexelBuffer(
-				srcInternal,
-				width, height,
-				_textureSize
-			);
+			filtered = false;
 			break;
 		}
+		im->pixmap = createTexelBuffer(srcInternal, width, height, _textureSize, filtered);
+
+		bool mipmapped;
+		switch (texture_min_filter) {
+		case TGL_LINEAR_MIPMAP_NEAREST:
+		case TGL_LINEAR_MIPMAP_LINEAR:
+		case TGL_NEAREST_MIPMAP_NEAREST:
+		case TGL_NEAREST_MIPMAP_LINEAR:
+			mipmapped = true;
+			break;
+		default:
+			mipmapped = false;
+			break;
+		}
+
+		// Minified triangles pick one of the levels generated here, see
+		// gl_draw_triangle_fill(). Each level keeps the texture size of the
+		// base level, so that texture coordinates are the same for all.
+		if (level == 0 && mipmapped) {
+			Graphics::PixelBuffer levelBuf = srcInternal;
+			byte *levelPixels = nullptr;
+			int levelWidth = width;
+			int levelHeight = height;
+			for (int i = 1; i < MAX_TEXTURE_LEVELS && (levelWidth > 1 || levelHeight > 1); i++) {
+				int nextWidth = MAX(levelWidth / 2, 1);
+				int nextHeight = MAX(levelHeight / 2, 1);
+				byte *nextPixels = new byte[nextWidth * nextHeight * internalPf.bytesPerPixel];
+				Graphics::PixelBuffer nextBuf(internalPf, nextPixels);
+				downsampleImage(levelBuf, levelWidth, levelHeight, nextBuf, nextWidth, nextHeight);
+
+				GLImage *levelImage = &current_texture->images[i];
+				levelImage->xsize = _textureSize;
+				levelImage->ysize = _textureSize;
+				levelImage->pixmap = createTexelBuffer(nextBuf, nextWidth, nextHeight, _textureSize, filtered);
+
+				delete[] levelPixels;
+				levelPixels = nextPixels;
+				levelBuf = nextBuf;
+				levelWidth = nextWidth;
+				levelHeight = nextHeight;
+			}
+			delete[] levelPixels;
+		}
 	}
 }
 
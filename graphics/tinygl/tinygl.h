@@ -27,6 +27,11 @@
 #include "graphics/tinygl/gl.h"
 #include "graphics/tinygl/zblit_public.h"
 
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
 namespace TinyGL {
 
 void createContext(int screenW, int screenH, Graphics::PixelFormat pixelFormat,
@@ -34,9 +39,37 @@ void createContext(int screenW, int screenH, Graphics::PixelFormat pixelFormat,
 void destroyContext();
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+/**
+ * Returns whether draw calls were issued since the last presentBuffer() call,
+ * meaning that the frame buffer does not reflect them yet.
+ */
+bool hasPendingDrawCalls();
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyToBuffer(const Graphics::PixelFormat &dstFormat);
 
+/**
+ * Outlines the dirty rectangles of the presented frames in the frame buffer,
+ * and logs how long finding them and rendering took. Only has an effect
+ * when dirty rects are enabled.
+ */
+void enableDirtyRectsDebug(bool enable);
+
+/**
+ * Serializes the draw calls of the next presented frame, along with the
+ * vertices, render state, textures and blit images they use, to a stream.
+ * The stream is written to by the next presentBuffer() call and is not
+ * taken ownership of.
+ */
+void captureNextFrame(Common::WriteStream *stream);
+
+/**
+ * Issues the draw calls of a frame saved by captureNextFrame(), so that the
+ * next presentBuffer() call renders it.
+ * @return false if the stream does not contain a capture made with the
+ *         same screen size and texture size as the current context.
+ */
+bool replayFrame(Common::SeekableReadStream *stream);
+
 } // end of namespace TinyGL
 
 #endif
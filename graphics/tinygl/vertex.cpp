@@ -188,16 +188,12 @@ void GLContext::gl_vertex_transform(GLVertex *v) {
 	v->clip_code = gl_clipcode(v->pc.X, v->pc.Y, v->pc.Z, v->pc.W);
 }
 
-void GLContext::glopVertex(GLParam *p) {
-	GLVertex *v;
-	int n, cnt;
+GLVertex *GLContext::gl_new_vertex() {
+	int n = vertex_n;
 
 	assert(in_begin != 0);
 
-	n = vertex_n;
-	cnt = vertex_cnt;
-	cnt++;
-	vertex_cnt = cnt;
+	vertex_cnt++;
 
 	// quick fix to avoid crashes on large polygons
 	if (n >= vertex_max) {
@@ -211,9 +207,14 @@ void GLContext::glopVertex(GLParam *p) {
 		gl_free(vertex);
 		vertex = newarray;
 	}
+
+	vertex_n = n + 1;
+	return &vertex[n];
+}
+
+void GLContext::glopVertex(GLParam *p) {
 	// new vertex entry
-	v = &vertex[n];
-	n++;
+	GLVertex *v = gl_new_vertex();
 
 	v->coord.X = p[1].f;
 	v->coord.Y = p[2].f;
@@ -246,8 +247,6 @@ void GLContext::glopVertex(GLParam *p) {
 	// edge flag
 
 	v->edge_flag = current_edge_flag;
-
-	vertex_n = n;
 }
 
 void GLContext::glopEnd(GLParam *) {
@@ -29,6 +29,10 @@
 
 #include <math.h>
 
+// Translucent spans of 32 bits pixels are blended a few pixels at a time where
+// an instruction set is available
+#include "common/simd.h"
+
 namespace TinyGL {
 
 Common::Point transformPoint(float x, float y, int rotation);
@@ -62,23 +66,26 @@ public:
 		_binaryTransparent = true;
 		for (int y = 0; y < surface.h; y++) {
 			int start = -1;
+			bool opaque = true;
 			for (int x = 0; x < surface.w; ++x) {
 				// We found a transparent pixel, so save a line from 'start' to the pixel before this.
 				uint8 r, g, b, a;
 				srcBuf.getARGBAt(x, a, r, g, b);
 				if (a != 0 && a != 0xFF) {
 					_binaryTransparent = false;
+					opaque = false;
 				}
 				if (a == 0 && start >= 0) {
-					_lines.push_back(Line(start, y, x - start, srcBuf.getRawBuffer(start), textureFormat));
+					_lines.push_back(Line(start, y, x - start, srcBuf.getRawBuffer(start), textureFormat, opaque));
 					start = -1;
 				} else if (a != 0 && start == -1) {
 					start = x;
+					opaque = a == 0xFF;
 				}
 			}
 			// end of the bitmap line. if start is an actual pixel save the line.
 			if (start >= 0) {
-				_lines.push_back(Line(start, y, surface.w - start, srcBuf.getRawBuffer(start), textureFormat));
+				_lines.push_back(Line(start, y, surface.w - start, srcBuf.getRawBuffer(start), textureFormat, opaque));
 			}
 			srcBuf.shiftBy(surface.w);
 		}
@@ -99,12 +106,13 @@ public:
 		int _y;
 		int _length;
 		byte *_pixels;
+		bool _opaque; // All the pixels of the line have full alpha.
 		Graphics::PixelBuffer _buf; // This is needed for the conversion.
 
-		Line() : _x(0), _y(0), _length(0), _pixels(nullptr) { }
-		Line(int x, int y, int length, byte *pixels, const Graphics::PixelFormat &textureFormat) :
+		Line() : _x(0), _y(0), _length(0), _pixels(nullptr), _opaque(true) { }
+		Line(int x, int y, int length, byte *pixels, const Graphics::PixelFormat &textureFormat, bool opaque) :
 				_buf(gl_get_context()->fb->getPixelFormat(), length, DisposeAfterUse::NO),
-				_x(x), _y(y), _length(length) {
+				_x(x), _y(y), _length(length), _opaque(opaque) {
 			// Performing texture to screen conversion.
 			Graphics::PixelBuffer srcBuf(textureFormat, pixels);
 			_buf.copyBuffer(0, 0, length, srcBuf);
@@ -116,6 +124,7 @@ public:
 				return *this;
 			_x = other._x;
 			_y = other._y;
+			_opaque = other._opaque;
 			if (_length != other._length || _buf.getFormat() != other._buf.getFormat()) {
 				_buf.free();
 				_buf.create(other._buf.getFormat(), other._length, DisposeAfterUse::NO);
@@ -126,7 +135,7 @@ public:
 			return *this;
 		}
 
-		Line(const Line& other) : _buf(other._buf.getFormat(), other._length, DisposeAfterUse::NO), _x(other._x), _y(other._y), _length(other._length) {
+		Line(const Line& other) : _buf(other._buf.getFormat(), other._length, DisposeAfterUse::NO), _x(other._x), _y(other._y), _length(other._length), _opaque(other._opaque) {
 			_buf.copyBuffer(0, 0, _length, other._buf);
 			_pixels = _buf.getRawBuffer();
 		}
@@ -210,6 +219,8 @@ public:
 			dstBuf.shiftBy(fbWidth);
 			srcBuf.shiftBy(_surface.w);
 		}
+
+		c->fb->invalidateDepthTiles(Common::Rect(dstX, dstY, dstX + clampWidth, dstY + clampHeight));
 	}
 
 	template <bool kDisableColoring, bool kDisableBlending, bool kEnableAlphaBlending>
@@ -258,6 +269,7 @@ public:
 
 	int getWidth() const { return _surface.w; }
 	int getHeight() const { return _surface.h; }
+	const Graphics::Surface &getSurface() const { return _surface; }
 	void incRefCount() { _refcount++; }
 	void dispose() { if (--_refcount == 0) _isDisposed = true; }
 	bool isDisposed() const { return _isDisposed; }
@@ -307,6 +319,112 @@ void tglDeleteBlitImage(TinyGL::BlitImage *blitImage) {
 
 namespace TinyGL {
 
+// Whole spans are only written directly when every channel of the frame buffer,
+// alpha included, takes a byte of a 32 bits pixel.
+static bool isByteAlignedFormat(const Graphics::PixelFormat &format) {
+	return format.bytesPerPixel == 4 && format.aLoss == 0 && format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+	       (format.aShift & 7) == 0 && (format.rShift & 7) == 0 && (format.gShift & 7) == 0 && (format.bShift & 7) == 0;
+}
+
+// Blends a span of pixels over the frame buffer like FrameBuffer::writePixel()
+// does with the TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA blending factors.
+// With kCopyOpaque, pixels with full alpha are copied instead.
+template <bool kCopyOpaque>
+static void blendSpan(uint32 *dst, const uint32 *src, int length, int aShift) {
+	const uint32 aMask = 0xFFu << aShift;
+	int i = 0;
+#if defined(SCUMMVM_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(0xFF);
+	const __m128i alphaMask = _mm_set1_epi32(aMask);
+	const __m128i alphaShift = _mm_cvtsi32_si128(aShift);
+	for (; i + 4 <= length; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		// Spread the alpha of each pixel over its four bytes.
+		__m128i a = _mm_and_si128(_mm_srl_epi32(s, alphaShift), _mm_set1_epi32(0xFF));
+		a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+		a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+		__m128i aLo = _mm_unpacklo_epi8(a, zero);
+		__m128i aHi = _mm_unpackhi_epi8(a, zero);
+		__m128i lo = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), aLo), 8),
+		                           _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, aLo)), 8));
+		__m128i hi = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), aHi), 8),
+		                           _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, aHi)), 8));
+		__m128i result = _mm_or_si128(_mm_packus_epi16(lo, hi), alphaMask);
+		if (kCopyOpaque) {
+			__m128i opaque = _mm_cmpeq_epi32(_mm_and_si128(s, alphaMask), alphaMask);
+			result = _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, result));
+		}
+		_mm_storeu_si128((__m128i *)(dst + i), result);
+	}
+#elif defined(SCUMMVM_SIMD_NEON)
+	const uint32x4_t alphaMask = vdupq_n_u32(aMask);
+	const int32x4_t alphaShift = vdupq_n_s32(-aShift);
+	for (; i + 4 <= length; i += 4) {
+		uint32x4_t s = vld1q_u32(src + i);
+		uint8x16_t s8 = vreinterpretq_u8_u32(s);
+		uint8x16_t d8 = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+		// Spread the alpha of each pixel over its four bytes.
+		uint32x4_t a = vandq_u32(vshlq_u32(s, alphaShift), vdupq_n_u32(0xFF));
+		uint8x16_t a8 = vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101));
+		uint8x16_t inva8 = vmvnq_u8(a8);
+		uint16x8_t lo = vaddq_u16(vshrq_n_u16(vmull_u8(vget_low_u8(s8), vget_low_u8(a8)), 8),
+		                          vshrq_n_u16(vmull_u8(vget_low_u8(d8), vget_low_u8(inva8)), 8));
+		uint16x8_t hi = vaddq_u16(vshrq_n_u16(vmull_u8(vget_high_u8(s8), vget_high_u8(a8)), 8),
+		                          vshrq_n_u16(vmull_u8(vget_high_u8(d8), vget_high_u8(inva8)), 8));
+		uint32x4_t result = vorrq_u32(vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi))), alphaMask);
+		if (kCopyOpaque) {
+			uint32x4_t opaque = vceqq_u32(vandq_u32(s, alphaMask), alphaMask);
+			result = vbslq_u32(opaque, s, result);
+		}
+		vst1q_u32(dst + i, result);
+	}
+#endif
+	for (; i < length; i++) {
+		uint32 s = src[i];
+		uint a = (s >> aShift) & 0xFF;
+		if (kCopyOpaque && a == 0xFF) {
+			dst[i] = s;
+			continue;
+		}
+		uint32 d = dst[i];
+		uint32 result = aMask;
+		for (int shift = 0; shift < 32; shift += 8) {
+			if (shift != aShift) {
+				uint value = ((((s >> shift) & 0xFF) * a) >> 8) + ((((d >> shift) & 0xFF) * (255 - a)) >> 8);
+				result |= MIN<uint>(value, 255) << shift;
+			}
+		}
+		dst[i] = result;
+	}
+}
+
+// Tints a span of pixels the same way the blits tint single pixels.
+static void tintSpan(uint32 *dst, const uint32 *src, int length, const Graphics::PixelFormat &format, float aTint, float rTint, float gTint, float bTint) {
+	for (int i = 0; i < length; i++) {
+		uint32 s = src[i];
+		byte a = ((s >> format.aShift) & 0xFF) * aTint;
+		byte r = ((s >> format.rShift) & 0xFF) * rTint;
+		byte g = ((s >> format.gShift) & 0xFF) * gTint;
+		byte b = ((s >> format.bShift) & 0xFF) * bTint;
+		dst[i] = (a << format.aShift) | (r << format.rShift) | (g << format.gShift) | (b << format.bShift);
+	}
+}
+
+static void blendTintedSpan(uint32 *dst, const uint32 *src, int length, const Graphics::PixelFormat &format, float aTint, float rTint, float gTint, float bTint) {
+	const int kChunkSize = 64;
+	uint32 tinted[kChunkSize];
+	while (length > 0) {
+		int count = MIN(length, kChunkSize);
+		tintSpan(tinted, src, count, format, aTint, rTint, gTint, bTint);
+		blendSpan<false>(dst, tinted, count, format.aShift);
+		dst += count;
+		src += count;
+		length -= count;
+	}
+}
+
 // This function uses RLE encoding to skip transparent bitmap parts
 // This blit only supports tinting but it will fall back to simpleBlit
 // if flipping is required (or anything more complex than that, including rotationd and scaling).
@@ -330,7 +448,12 @@ FORCEINLINE void BlitImage::tglBlitRLE(int dstX, int dstY, int srcX, int srcY, i
 	Graphics::PixelBuffer dstBuf(c->fb->getPixelFormat(), c->fb->getPixelBuffer());
 	dstBuf.shiftBy(dstY * fbWidth + dstX);
 
-	int kBytesPerPixel = c->fb->getPixelFormat().bytesPerPixel;
+	Graphics::PixelFormat fbFormat = c->fb->getPixelFormat();
+	int kBytesPerPixel = fbFormat.bytesPerPixel;
+
+	// Tinted and alpha blended lines are written a span at a time when the
+	// frame buffer writes depend on nothing but the blending factors.
+	bool writeSpans = !c->alpha_test_enabled && isByteAlignedFormat(fbFormat);
 
 	uint32 lineIndex = 0;
 	int maxY = srcY + clampHeight;
@@ -355,6 +478,14 @@ FORCEINLINE void BlitImage::tglBlitRLE(int dstX, int dstY, int srcX, int srcY, i
 					int xStart = MAX(l._x - srcX, 0);
 					if (kDisableColoring) {
 						dstBuf.copyBuffer(xStart + (l._y - srcY) * fbWidth, skipStart, length, l._buf);
+					} else if (writeSpans) {
+						uint32 *dst = (uint32 *)dstBuf.getRawBuffer(xStart + (l._y - srcY) * fbWidth);
+						const uint32 *src = (const uint32 *)l._pixels + skipStart;
+						if (kDisableBlending) {
+							tintSpan(dst, src, length, fbFormat, aTint, rTint, gTint, bTint);
+						} else {
+							blendTintedSpan(dst, src, length, fbFormat, aTint, rTint, gTint, bTint);
+						}
 					} else {
 						for(int x = xStart; x < xStart + length; x++) {
 							byte aDst, rDst, gDst, bDst;
@@ -378,6 +509,16 @@ FORCEINLINE void BlitImage::tglBlitRLE(int dstX, int dstY, int srcX, int srcY, i
 				if (kDisableColoring && (kEnableAlphaBlending == false || kDisableBlending)) {
 					memcpy(dstBuf.getRawBuffer((l._y - srcY) * fbWidth + MAX(l._x - srcX, 0)),
 						l._pixels + skipStart * kBytesPerPixel, length * kBytesPerPixel);
+				} else if (writeSpans) {
+					uint32 *dst = (uint32 *)dstBuf.getRawBuffer((l._y - srcY) * fbWidth + MAX(l._x - srcX, 0));
+					const uint32 *src = (const uint32 *)l._pixels + skipStart;
+					if (!kDisableColoring) {
+						blendTintedSpan(dst, src, length, fbFormat, aTint, rTint, gTint, bTint);
+					} else if (l._opaque) {
+						memcpy(dst, src, length * kBytesPerPixel);
+					} else {
+						blendSpan<true>(dst, src, length, fbFormat.aShift);
+					}
 				} else {
 					int xStart = MAX(l._x - srcX, 0);
 					for(int x = xStart; x < xStart + length; x++) {
@@ -740,6 +881,10 @@ void tglBlitZBuffer(BlitImage *blitImage, int x, int y) {
 	blitImage->tglBlitZBuffer(x, y);
 }
 
+const Graphics::Surface &tglGetBlitImageSurface(BlitImage *blitImage) {
+	return blitImage->getSurface();
+}
+
 void tglCleanupImages() {
 	GLContext *c = gl_get_context();
 	Common::List<BlitImage *>::iterator it = c->_blitImages.begin();
@@ -48,6 +48,9 @@ namespace Internal {
 
 	void tglBlitZBuffer(BlitImage *blitImage, int x, int y);
 
+	// Returns the image data of a blit image, after color keying.
+	const Graphics::Surface &tglGetBlitImageSurface(BlitImage *blitImage);
+
 	/**
 	@brief Sets up a scissor rectangle for blit calls: every blit call is affected by this rectangle.
 	*/
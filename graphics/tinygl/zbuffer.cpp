@@ -88,18 +88,26 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 
 	_pbuf.set(_pbufFormat, new byte[_pbufHeight * _pbufPitch]);
 	_zbuf = (uint *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(uint));
+	_sbuf = nullptr;
 	if (enableStencilBuffer)
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
 
 	_offscreenBuffer.pbuf = _pbuf.getRawBuffer();
 	_offscreenBuffer.zbuf = _zbuf;
 
+	_depthTilesWidth = (_pbufWidth + (1 << ZB_DEPTH_TILE_BITS) - 1) >> ZB_DEPTH_TILE_BITS;
+	_depthTilesHeight = (_pbufHeight + (1 << ZB_DEPTH_TILE_BITS) - 1) >> ZB_DEPTH_TILE_BITS;
+	_depthTiles = new DepthTile[_depthTilesWidth * _depthTilesHeight];
+	setDepthTiles(Common::Rect(_pbufWidth, _pbufHeight), 0);
+
 	_currentTexture = nullptr;
+	_enableScissor = false;
 }
 
 FrameBuffer::~FrameBuffer() {
 	_pbuf.free();
 	gl_free(_zbuf);
+	delete[] _depthTiles;
 	if (_sbuf)
 		gl_free(_sbuf);
 }
@@ -130,6 +138,7 @@ void FrameBuffer::clear(int clearZ, int z, int clearColor, int r, int g, int b,
 			// Cannot use memset, use a variant working on integers (slow)
 			memset_l(_zbuf, z, _pbufWidth * _pbufHeight);
 		}
+		setDepthTiles(Common::Rect(_pbufWidth, _pbufHeight), z);
 	}
 	if (clearColor) {
 		byte *pp = _pbuf.getRawBuffer();
@@ -180,6 +189,7 @@ void FrameBuffer::clearRegion(int x, int y, int w, int h, bool clearZ, int z,
 				zbuf += _pbufWidth;
 			}
 		}
+		setDepthTiles(Common::Rect(x, y, x + w, y + h), z);
 	}
 	if (clearColor) {
 		int height = h;
@@ -220,6 +230,126 @@ void FrameBuffer::clearRegion(int x, int y, int w, int h, bool clearZ, int z,
 	}
 }
 
+void FrameBuffer::invalidateDepthTiles(const Common::Rect &area) {
+	Common::Rect rect = area;
+	rect.clip(Common::Rect(_pbufWidth, _pbufHeight));
+	if (rect.isEmpty())
+		return;
+
+	int tileLeft = rect.left >> ZB_DEPTH_TILE_BITS;
+	int tileRight = (rect.right - 1) >> ZB_DEPTH_TILE_BITS;
+	int tileTop = rect.top >> ZB_DEPTH_TILE_BITS;
+	int tileBottom = (rect.bottom - 1) >> ZB_DEPTH_TILE_BITS;
+	for (int tileY = tileTop; tileY <= tileBottom; tileY++) {
+		DepthTile *tile = _depthTiles + tileY * _depthTilesWidth + tileLeft;
+		for (int tileX = tileLeft; tileX <= tileRight; tileX++, tile++)
+			tile->dirty = true;
+	}
+}
+
+// Tiles entirely inside the area take the cleared value as their range, the
+// ones partially covered are recomputed later.
+void FrameBuffer::setDepthTiles(const Common::Rect &area, uint z) {
+	Common::Rect rect = area;
+	rect.clip(Common::Rect(_pbufWidth, _pbufHeight));
+	if (rect.isEmpty())
+		return;
+
+	const int tileSize = 1 << ZB_DEPTH_TILE_BITS;
+	int tileLeft = rect.left >> ZB_DEPTH_TILE_BITS;
+	int tileRight = (rect.right - 1) >> ZB_DEPTH_TILE_BITS;
+	int tileTop = rect.top >> ZB_DEPTH_TILE_BITS;
+	int tileBottom = (rect.bottom - 1) >> ZB_DEPTH_TILE_BITS;
+	for (int tileY = tileTop; tileY <= tileBottom; tileY++) {
+		int y = tileY << ZB_DEPTH_TILE_BITS;
+		bool coversRows = rect.top <= y && (rect.bottom >= y + tileSize || rect.bottom == _pbufHeight);
+		DepthTile *tile = _depthTiles + tileY * _depthTilesWidth + tileLeft;
+		for (int tileX = tileLeft; tileX <= tileRight; tileX++, tile++) {
+			int x = tileX << ZB_DEPTH_TILE_BITS;
+			if (coversRows && rect.left <= x && (rect.right >= x + tileSize || rect.right == _pbufWidth)) {
+				tile->zMin = tile->zMax = z;
+				tile->dirty = false;
+			} else {
+				tile->dirty = true;
+			}
+		}
+	}
+}
+
+void FrameBuffer::updateDepthTile(int tileX, int tileY) {
+	int left = tileX << ZB_DEPTH_TILE_BITS;
+	int top = tileY << ZB_DEPTH_TILE_BITS;
+	int right = MIN(left + (1 << ZB_DEPTH_TILE_BITS), _pbufWidth);
+	int bottom = MIN(top + (1 << ZB_DEPTH_TILE_BITS), _pbufHeight);
+
+	uint zMin = 0xFFFFFFFF, zMax = 0;
+	for (int y = top; y < bottom; y++) {
+		const uint *zbuf = _zbuf + y * _pbufWidth;
+		for (int x = left; x < right; x++) {
+			zMin = MIN(zMin, zbuf[x]);
+			zMax = MAX(zMax, zbuf[x]);
+		}
+	}
+
+	DepthTile *tile = _depthTiles + tileY * _depthTilesWidth + tileX;
+	tile->zMin = zMin;
+	tile->zMax = zMax;
+	tile->dirty = false;
+}
+
+// Returns true if a primitive covering the area with depths between zMin and
+// zMax would fail the depth test everywhere. The depth test passes for the
+// incoming z when compareDepth() finds it closer, i.e. larger for TGL_LESS.
+bool FrameBuffer::areDepthTilesHiding(const Common::Rect &area, uint zMin, uint zMax) {
+	switch (_depthFunc) {
+	case TGL_NEVER:
+		return true;
+	case TGL_LESS:
+	case TGL_LEQUAL:
+	case TGL_GREATER:
+	case TGL_GEQUAL:
+	case TGL_EQUAL:
+		break;
+	default:
+		return false;
+	}
+
+	int tileLeft = area.left >> ZB_DEPTH_TILE_BITS;
+	int tileRight = (area.right - 1) >> ZB_DEPTH_TILE_BITS;
+	int tileTop = area.top >> ZB_DEPTH_TILE_BITS;
+	int tileBottom = (area.bottom - 1) >> ZB_DEPTH_TILE_BITS;
+	for (int tileY = tileTop; tileY <= tileBottom; tileY++) {
+		DepthTile *tile = _depthTiles + tileY * _depthTilesWidth + tileLeft;
+		for (int tileX = tileLeft; tileX <= tileRight; tileX++, tile++) {
+			if (tile->dirty)
+				updateDepthTile(tileX, tileY);
+
+			bool hidden;
+			switch (_depthFunc) {
+			case TGL_LESS:
+				hidden = zMax <= tile->zMin;
+				break;
+			case TGL_LEQUAL:
+				hidden = zMax < tile->zMin;
+				break;
+			case TGL_GREATER:
+				hidden = zMin >= tile->zMax;
+				break;
+			case TGL_GEQUAL:
+				hidden = zMin > tile->zMax;
+				break;
+			default:
+				hidden = zMax < tile->zMin || zMin > tile->zMax;
+				break;
+			}
+			// Stop at the first tile with a visible pixel
+			if (!hidden)
+				return false;
+		}
+	}
+	return true;
+}
+
 inline static void blitPixel(uint8 offset, uint *from_z, uint *to_z, uint z_length, byte *from_color, byte *to_color, uint color_length) {
 	const uint d = from_z[offset];
 	if (d > to_z[offset]) {
@@ -279,6 +409,7 @@ void FrameBuffer::blitOffscreenBuffer(Buffer *buf) {
 		case 0x1: blitPixel(0x0, from_z, to_z, sizeof(int), from, to, pixel_bytes); // fall through
 		case 0x0: break;
 		}
+		invalidateDepthTiles(Common::Rect(_pbufWidth, _pbufHeight));
 	}
 #undef UNROLL_COUNT
 }
@@ -292,6 +423,7 @@ void FrameBuffer::selectOffscreenBuffer(Buffer *buf) {
 		_pbuf = _offscreenBuffer.pbuf;
 		_zbuf = _offscreenBuffer.zbuf;
 	}
+	invalidateDepthTiles(Common::Rect(_pbufWidth, _pbufHeight));
 }
 
 void FrameBuffer::clearOffscreenBuffer(Buffer *buf) {
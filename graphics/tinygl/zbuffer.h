@@ -43,6 +43,9 @@ namespace TinyGL {
 
 #define ZB_POINT_Z_FRAC_BITS 14
 
+// Size of the tiles of the coarse depth buffer, as a power of two
+#define ZB_DEPTH_TILE_BITS 3
+
 #define ZB_POINT_ST_FRAC_BITS 14
 #define ZB_POINT_ST_FRAC_SHIFT     (ZB_POINT_ST_FRAC_BITS - 1)
 #define ZB_POINT_ST_MAX            ( (_textureSize << ZB_POINT_ST_FRAC_BITS) - 1 )
@@ -124,6 +127,12 @@ struct FrameBuffer {
 		return _zbuf;
 	}
 
+	/**
+	 * Marks the depth range of the tiles covering an area as out of date.
+	 * Has to be called after writing to the z buffer directly.
+	 */
+	void invalidateDepthTiles(const Common::Rect &area);
+
 	Graphics::Surface *copyToBuffer(const Graphics::PixelFormat &dstFormat) {
 		Graphics::Surface tmp;
 		tmp.init(_pbufWidth, _pbufHeight, _pbufPitch, _pbuf.getRawBuffer(), _pbufFormat);
@@ -641,6 +650,10 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kDepthWrite, bool kEnableScissor>
 	FORCEINLINE void drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2);
 
+	bool areDepthTilesHiding(const Common::Rect &area, uint zMin, uint zMax);
+	void updateDepthTile(int tileX, int tileY);
+	void setDepthTiles(const Common::Rect &area, uint z);
+
 	Buffer _offscreenBuffer;
 	Graphics::PixelBuffer _pbuf;
 	int _pbufWidth;
@@ -652,6 +665,17 @@ private:
 	uint *_zbuf;
 	byte *_sbuf;
 
+	// Coarse depth buffer: the range of the z values of each tile of the z
+	// buffer, used to reject hidden triangles without rasterizing them. The
+	// range of a tile drawn to is recomputed when it is next needed.
+	struct DepthTile {
+		uint zMin, zMax;
+		bool dirty;
+	};
+	DepthTile *_depthTiles;
+	int _depthTilesWidth;
+	int _depthTilesHeight;
+
 	bool _enableStencil;
 	int _textureSize;
 	int _textureSizeMask;
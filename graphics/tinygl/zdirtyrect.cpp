@@ -20,11 +20,13 @@
  */
 
 #include "graphics/tinygl/zdirtyrect.h"
+#include "graphics/tinygl/framecapture.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/system.h"
 
 namespace TinyGL {
 
@@ -113,10 +115,116 @@ static inline void _appendDirtyRectangle(const DrawCall &call, Common::List<Dirt
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
+// Dirty rectangles indexed by the screen tiles they cover, so that finding
+// the rectangles intersecting an area only looks at the ones near it.
+class DirtyRectangleGrid {
+public:
+	DirtyRectangleGrid(int width, int height) : _stamp(0) {
+		_tilesWidth = (width >> kTileBits) + 1;
+		_tilesHeight = (height >> kTileBits) + 1;
+		_tiles.resize(_tilesWidth * _tilesHeight);
+	}
+
+	// Adds a rectangle, merged with all the rectangles it intersects, and
+	// the ones the merged rectangle then intersects, into their bounding
+	// rectangle. Rectangles merged into another one are left empty.
+	void merge(DirtyRectangle rect) {
+		int left, right, top, bottom;
+		bool merged;
+		do {
+			merged = false;
+			getTileRange(rect.rectangle, left, right, top, bottom);
+			for (int tileY = top; tileY <= bottom; tileY++) {
+				for (int tileX = left; tileX <= right; tileX++) {
+					Common::Array<int> &tile = _tiles[tileY * _tilesWidth + tileX];
+					for (uint i = 0; i < tile.size(); ) {
+						DirtyRectangle &other = _rectangles[tile[i]];
+						if (other.rectangle.isEmpty()) {
+							// Drop the rectangles merged into another one
+							tile[i] = tile.back();
+							tile.pop_back();
+							continue;
+						}
+						if (other.rectangle.intersects(rect.rectangle)) {
+							// Already covered, nothing changes
+							if (other.rectangle.contains(rect.rectangle))
+								return;
+							rect.rectangle.extend(other.rectangle);
+							other.rectangle = Common::Rect();
+							merged = true;
+						}
+						i++;
+					}
+				}
+			}
+		} while (merged);
+
+		int index = _rectangles.size();
+		_rectangles.push_back(rect);
+		_stamps.push_back(0);
+		getTileRange(rect.rectangle, left, right, top, bottom);
+		for (int tileY = top; tileY <= bottom; tileY++) {
+			for (int tileX = left; tileX <= right; tileX++)
+				_tiles[tileY * _tilesWidth + tileX].push_back(index);
+		}
+	}
+
+	// Appends the index of each non empty rectangle intersecting the area,
+	// once per rectangle.
+	void findIntersecting(const Common::Rect &area, Common::Array<int> &indices) {
+		int left, right, top, bottom;
+		getTileRange(area, left, right, top, bottom);
+		_stamp++;
+		for (int tileY = top; tileY <= bottom; tileY++) {
+			for (int tileX = left; tileX <= right; tileX++) {
+				const Common::Array<int> &tile = _tiles[tileY * _tilesWidth + tileX];
+				for (uint i = 0; i < tile.size(); i++) {
+					int index = tile[i];
+					const Common::Rect &rectangle = _rectangles[index].rectangle;
+					if (_stamps[index] != _stamp && !rectangle.isEmpty() && rectangle.intersects(area)) {
+						_stamps[index] = _stamp;
+						indices.push_back(index);
+					}
+				}
+			}
+		}
+	}
+
+	Common::Array<DirtyRectangle> &getRectangles() {
+		return _rectangles;
+	}
+
+private:
+	enum {
+		kTileBits = 6
+	};
+
+	// Empty areas get an empty range
+	void getTileRange(const Common::Rect &area, int &left, int &right, int &top, int &bottom) const {
+		if (area.isEmpty()) {
+			left = top = 0;
+			right = bottom = -1;
+			return;
+		}
+		left = CLIP<int>(area.left >> kTileBits, 0, _tilesWidth - 1);
+		right = CLIP<int>((area.right - 1) >> kTileBits, 0, _tilesWidth - 1);
+		top = CLIP<int>(area.top >> kTileBits, 0, _tilesHeight - 1);
+		bottom = CLIP<int>((area.bottom - 1) >> kTileBits, 0, _tilesHeight - 1);
+	}
+
+	Common::Array<DirtyRectangle> _rectangles;
+	Common::Array<Common::Array<int> > _tiles;
+	Common::Array<uint> _stamps;
+	uint _stamp;
+	int _tilesWidth, _tilesHeight;
+};
+
 void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
 	typedef Common::List<DirtyRectangle>::iterator RectangleIterator;
 
+	uint32 startTime = _debugRectsEnabled ? g_system->getMillis() : 0;
+
 	Common::List<DirtyRectangle> rectangles;
 
 	DrawCallIterator itFrame = _drawCallsQueue.begin();
@@ -144,81 +252,73 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
 	}
 
-	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
+	uint32 diffTime = _debugRectsEnabled ? g_system->getMillis() : 0;
+
+	// Merge coalesce dirty rects. Outer rectangle coordinates are increased
+	// to favor merging of adjacent rectangles.
+	DirtyRectangleGrid grid(fb->getPixelBufferWidth(), fb->getPixelBufferHeight());
 	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
 		(*it).rectangle.right++;
 		(*it).rectangle.bottom++;
+		grid.merge(*it);
 	}
 
-	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
-			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
+	// Find the draw calls touching each merged rectangle, in order.
+	Common::Array<DirtyRectangle> &mergedRectangles = grid.getRectangles();
+	Common::Array<Common::Array<DrawCall *> > rectangleDrawCalls;
+	rectangleDrawCalls.resize(mergedRectangles.size());
+	for (uint i = 0; i < mergedRectangles.size(); i++) {
+		mergedRectangles[i].rectangle.clip(renderRect);
+	}
+	Common::Array<int> intersecting;
+	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+		intersecting.clear();
+		grid.findIntersecting((*it)->getDirtyRegion(), intersecting);
+		for (uint i = 0; i < intersecting.size(); i++) {
+			rectangleDrawCalls[intersecting[i]].push_back(*it);
 		}
 	}
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		(*it1).rectangle.clip(renderRect);
-	}
+	uint32 mergeTime = _debugRectsEnabled ? g_system->getMillis() : 0;
 
-	if (!rectangles.empty()) {
-		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-			dirtyAreas.push_back((*itRect).rectangle);
-		}
+	// Execute draw calls, one dirty rectangle at a time. Rectangles do not
+	// overlap after merging, so this produces the same result as going
+	// through the draw calls in order, but keeps the color, depth and
+	// stencil buffers of the region being rendered in the cache.
+	int dirtyRectangleCount = 0;
+	for (uint i = 0; i < mergedRectangles.size(); i++) {
+		const Common::Rect &dirtyRegion = mergedRectangles[i].rectangle;
+		if (dirtyRegion.isEmpty())
+			continue;
 
-		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
-				}
-			}
+		dirtyAreas.push_back(dirtyRegion);
+		dirtyRectangleCount++;
+		for (uint j = 0; j < rectangleDrawCalls[i].size(); j++) {
+			rectangleDrawCalls[i][j]->execute(dirtyRegion, true);
 		}
+	}
 
-		if (_debugRectsEnabled) {
-			// Draw debug rectangles.
-			// Note: white rectangles are rectangle that contained other rectangles
-			// blue rectangles are rectangle merged from other rectangles
-			// red rectangles are original dirty rects
+	if (_debugRectsEnabled) {
+		// Draw debug rectangles.
+		// Note: white rectangles are rectangle that contained other rectangles
+		// blue rectangles are rectangle merged from other rectangles
+		// red rectangles are original dirty rects
 
-			fb->enableBlending(false);
-			fb->enableAlphaTest(false);
+		fb->enableBlending(false);
+		fb->enableAlphaTest(false);
 
-			for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-				debugDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
-			}
-
-			fb->enableBlending(blending_enabled);
-			fb->enableAlphaTest(alpha_test_enabled);
+		for (uint i = 0; i < mergedRectangles.size(); i++) {
+			const DirtyRectangle &rect = mergedRectangles[i];
+			if (!rect.rectangle.isEmpty())
+				debugDrawRectangle(rect.rectangle, rect.r, rect.g, rect.b);
 		}
+
+		fb->enableBlending(blending_enabled);
+		fb->enableAlphaTest(alpha_test_enabled);
+
+		debug("TinyGL: %d draw calls, %d dirty rectangles merged into %d, diffing took %d ms, merging %d ms, rendering %d ms",
+		      (int)_drawCallsQueue.size(), (int)rectangles.size(), dirtyRectangleCount,
+		      (int)(diffTime - startTime), (int)(mergeTime - diffTime), (int)(g_system->getMillis() - mergeTime));
 	}
 
 	// Dispose not necessary draw calls.
@@ -254,6 +354,10 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
+	if (c->_frameCaptureStream) {
+		FrameCapture::writeFrame(*c->_frameCaptureStream, c->_drawCallsQueue);
+		c->_frameCaptureStream = nullptr;
+	}
 	if (c->_enableDirtyRectangles) {
 		c->presentBufferDirtyRects(dirtyAreas);
 	} else {
@@ -266,6 +370,15 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+bool hasPendingDrawCalls() {
+	return !gl_get_context()->_drawCallsQueue.empty();
+}
+
+void enableDirtyRectsDebug(bool enable) {
+	GLContext *c = gl_get_context();
+	c->_debugRectsEnabled = enable;
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -350,7 +463,6 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
-	int n = c->vertex_n;
 	int cnt = c->vertex_cnt;
 
 	switch (c->begin_type) {
@@ -398,21 +510,24 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		}
 		break;
 	case TGL_QUADS:
+		// The vertices are restored afterwards, as the draw call can be
+		// executed again and is compared with the next frame's
 		for(int i = 0; i < cnt; i += 4) {
+			int edgeFlag0 = c->vertex[i + 0].edge_flag;
+			int edgeFlag2 = c->vertex[i + 2].edge_flag;
 			c->vertex[i + 2].edge_flag = 0;
 			c->gl_draw_triangle(&c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
 			c->vertex[i + 2].edge_flag = 1;
 			c->vertex[i + 0].edge_flag = 0;
 			c->gl_draw_triangle(&c->vertex[i], &c->vertex[i + 2], &c->vertex[i + 3]);
+			c->vertex[i + 0].edge_flag = edgeFlag0;
+			c->vertex[i + 2].edge_flag = edgeFlag2;
 		}
 		break;
 	case TGL_QUAD_STRIP:
-		for( ; n >= 4; n -= 2) {
-			c->gl_draw_triangle(&c->vertex[0], &c->vertex[1], &c->vertex[2]);
-			c->gl_draw_triangle(&c->vertex[1], &c->vertex[3], &c->vertex[2]);
-			for (int i = 0; i < 2; i++) {
-				c->vertex[i] = c->vertex[i + 2];
-			}
+		for(int i = 0; i + 4 <= cnt; i += 2) {
+			c->gl_draw_triangle(&c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
+			c->gl_draw_triangle(&c->vertex[i + 1], &c->vertex[i + 3], &c->vertex[i + 2]);
 		}
 		break;
 	case TGL_POLYGON: {
@@ -433,7 +548,7 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() {
 	RasterizationState state;
 	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
@@ -480,7 +595,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
+void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) {
 	GLContext *c = gl_get_context();
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
@@ -608,7 +723,7 @@ void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool resto
 	Internal::tglBlitResetScissorRect();
 }
 
-BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
+BlittingDrawCall::BlittingState BlittingDrawCall::captureState() {
 	BlittingState state;
 	TinyGL::GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
@@ -621,7 +736,7 @@ BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	return state;
 }
 
-void BlittingDrawCall::applyState(const BlittingState &state) const {
+void BlittingDrawCall::applyState(const BlittingState &state) {
 	TinyGL::GLContext *c = gl_get_context();
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
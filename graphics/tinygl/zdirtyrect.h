@@ -64,6 +64,7 @@ private:
 };
 
 class ClearBufferDrawCall : public DrawCall {
+	friend class FrameCapture;
 public:
 	ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue, bool clearStencilBuffer, int stencilValue);
 	virtual ~ClearBufferDrawCall() { }
@@ -83,6 +84,7 @@ private:
 
 // Encapsulate a rasterization call: it might execute either a triangle or line rasterization.
 class RasterizationDrawCall : public DrawCall {
+	friend class FrameCapture;
 public:
 	RasterizationDrawCall();
 	virtual ~RasterizationDrawCall() { }
@@ -146,12 +148,13 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	static RasterizationState captureState();
+	static void applyState(const RasterizationState &state);
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
 class BlittingDrawCall : public DrawCall {
+	friend class FrameCapture;
 public:
 	enum BlittingMode {
 		BlitMode_Regular,
@@ -199,8 +202,8 @@ private:
 		}
 	};
 
-	BlittingState captureState() const;
-	void applyState(const BlittingState &state) const;
+	static BlittingState captureState();
+	static void applyState(const BlittingState &state);
 
 	BlittingState _blitState;
 };
@@ -43,6 +43,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class WriteStream;
+}
+
 namespace TinyGL {
 
 enum {
@@ -384,6 +388,15 @@ struct GLContext {
 	int texcoord_array_type;
 	int client_states;
 
+	// glDrawElements post-transform cache: for each array index, the draw
+	// it was last processed in and its entry in the vertex array.
+	struct VertexCacheEntry {
+		uint stamp;
+		int vertex;
+	};
+	Common::Array<VertexCacheEntry> vertex_cache;
+	uint vertex_cache_stamp;
+
 	// opengl 1.1 polygon offset
 	float offset_factor;
 	float offset_units;
@@ -434,6 +447,11 @@ struct GLContext {
 	LinearAllocator _drawCallAllocator[2];
 	bool _debugRectsEnabled;
 
+	// Frame capture and replay
+	Common::WriteStream *_frameCaptureStream;
+	Common::Array<TGLuint> _replayTextures;
+
+	GLVertex *gl_new_vertex();
 	void gl_vertex_transform(GLVertex *v);
 
 public:
@@ -448,6 +466,7 @@ public:
 	void gl_eval_viewport();
 	void gl_transform_to_viewport(GLVertex *v);
 	void gl_draw_triangle(GLVertex *p0, GLVertex *p1, GLVertex *p2);
+	bool gl_is_triangle_culled(GLVertex *p0, GLVertex *p1, GLVertex *p2);
 	void gl_draw_line(GLVertex *p0, GLVertex *p1);
 	void gl_draw_point(GLVertex *p0);
 
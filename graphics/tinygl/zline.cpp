@@ -73,6 +73,11 @@ void FrameBuffer::drawLine(const ZBufferPoint *p1, const ZBufferPoint *p2) {
 	// rounding-error-free) so that interpolations are possible without
 	// code duplication.
 
+	if (kDepthWrite) {
+		invalidateDepthTiles(Common::Rect(MIN(p1->x, p2->x), MIN(p1->y, p2->y),
+		                                  MAX(p1->x, p2->x) + 1, MAX(p1->y, p2->y) + 1));
+	}
+
 	// Where we are in unidimensional framebuffer coordinate
 	unsigned int pixelOffset = p1->y * _pbufWidth + p1->x;
 	// and in 2d
@@ -144,10 +149,12 @@ void FrameBuffer::plot(ZBufferPoint *p) {
 	const uint pixelOffset = p->y * _pbufWidth + p->x;
 	const int col = RGB_TO_PIXEL(p->r, p->g, p->b);
 	const uint z = p->z;
-	if (_depthWrite && _depthTestEnabled)
+	if (_depthWrite && _depthTestEnabled) {
+		invalidateDepthTiles(Common::Rect(p->x, p->y, p->x + 1, p->y + 1));
 		putPixel<true>(pixelOffset, col, p->x, p->y, z);
-	else
+	} else {
 		putPixel<false>(pixelOffset, col, p->x, p->y, z);
+	}
 }
 
 void FrameBuffer::fillLineFlatZ(ZBufferPoint *p1, ZBufferPoint *p2) {
@@ -30,32 +30,102 @@
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
 
+// The depth test of whole pixel groups is vectorized where an instruction set
+// is available
+#include "common/simd.h"
+
 namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
+#ifdef SCUMMVM_SIMD
+
+// Returns true when none of the four pixels of a span starting at pz, with
+// the depth z interpolated by dzdx, would pass the depth test.
+static FORCEINLINE bool depthTestRejects4(int depthFunc, uint z, int dzdx, const uint *pz) {
+#ifdef SCUMMVM_SIMD_SSE2
+	// SSE2 only has signed comparisons, so both sides are biased
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i steps = _mm_set_epi32((int)(3 * (uint)dzdx), (int)(2 * (uint)dzdx), dzdx, 0);
+	const __m128i zSrc = _mm_xor_si128(_mm_add_epi32(_mm_set1_epi32((int)z), steps), bias);
+	const __m128i zDst = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pz), bias);
+	switch (depthFunc) {
+	case TGL_NEVER:
+		return true;
+	case TGL_LESS:
+		return _mm_movemask_epi8(_mm_cmplt_epi32(zDst, zSrc)) == 0;
+	case TGL_EQUAL:
+		return _mm_movemask_epi8(_mm_cmpeq_epi32(zDst, zSrc)) == 0;
+	case TGL_LEQUAL:
+		return _mm_movemask_epi8(_mm_cmpgt_epi32(zDst, zSrc)) == 0xFFFF;
+	case TGL_GREATER:
+		return _mm_movemask_epi8(_mm_cmpgt_epi32(zDst, zSrc)) == 0;
+	case TGL_NOTEQUAL:
+		return _mm_movemask_epi8(_mm_cmpeq_epi32(zDst, zSrc)) == 0xFFFF;
+	case TGL_GEQUAL:
+		return _mm_movemask_epi8(_mm_cmplt_epi32(zDst, zSrc)) == 0xFFFF;
+	default:
+		return false;
+	}
+#else
+	const uint32 stepValues[4] = { 0, (uint32)dzdx, 2 * (uint32)dzdx, 3 * (uint32)dzdx };
+	const uint32x4_t zSrc = vaddq_u32(vdupq_n_u32(z), vld1q_u32(stepValues));
+	const uint32x4_t zDst = vld1q_u32((const uint32 *)pz);
+	uint32x4_t pass;
+	switch (depthFunc) {
+	case TGL_NEVER:
+		return true;
+	case TGL_LESS:
+		pass = vcltq_u32(zDst, zSrc);
+		break;
+	case TGL_EQUAL:
+		pass = vceqq_u32(zDst, zSrc);
+		break;
+	case TGL_LEQUAL:
+		pass = vcleq_u32(zDst, zSrc);
+		break;
+	case TGL_GREATER:
+		pass = vcgtq_u32(zDst, zSrc);
+		break;
+	case TGL_NOTEQUAL:
+		pass = vmvnq_u32(vceqq_u32(zDst, zSrc));
+		break;
+	case TGL_GEQUAL:
+		pass = vcgeq_u32(zDst, zSrc);
+		break;
+	default:
+		return false;
+	}
+	const uint32x2_t any = vorr_u32(vget_low_u32(pass), vget_high_u32(pass));
+	return (vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) == 0;
+#endif
+}
+
+#endif
+
 template <bool kDepthWrite, bool kSmoothMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 FORCEINLINE void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
 	                                        int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
 	                                        int &dzdx, int &drdx, int &dgdx, int &dbdx, uint dadx) {
-	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
+	// The interpolants are stepped below even for pixels that are scissored
+	// or fail the stencil test, as the following pixels of the span rely on it
+	bool visible = !kEnableScissor || !scissorPixel(x + _a, y);
+	if (visible && kStencilEnabled) {
+		visible = stencilTest(ps[_a]);
+		if (!visible) {
 			stencilOp(false, true, ps + _a);
-			return;
 		}
 	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
-	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
+	bool depthTestResult = false;
+	if (visible) {
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
 	}
 	if (depthTestResult) {
 		writePixel<kEnableAlphaTest, kEnableBlending, kDepthWrite>(fbOffset + _a, a >> (ZB_POINT_ALPHA_BITS - 8), r >> (ZB_POINT_RED_BITS - 8), g >> (ZB_POINT_GREEN_BITS - 8), b >> (ZB_POINT_BLUE_BITS - 8), z);
@@ -75,24 +145,23 @@ FORCEINLINE void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *t
 	                                      int x, int y, uint &z, int &t, int &s,
 	                                      uint &r, uint &g, uint &b, uint &a,
 	                                      int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx) {
-	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
+	bool visible = !kEnableScissor || !scissorPixel(x + _a, y);
+	if (visible && kStencilEnabled) {
+		visible = stencilTest(ps[_a]);
+		if (!visible) {
 			stencilOp(false, true, ps + _a);
-			return;
 		}
 	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
-	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
+	bool depthTestResult = false;
+	if (visible) {
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
 	}
 	if (depthTestResult) {
 		uint8 c_a, c_r, c_g, c_b;
@@ -122,24 +191,23 @@ FORCEINLINE void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *t
 
 template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 FORCEINLINE void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx) {
-	if (kEnableScissor && scissorPixel(x + _a, y)) {
-		return;
-	}
-	if (kStencilEnabled) {
-		bool stencilResult = stencilTest(ps[_a]);
-		if (!stencilResult) {
+	bool visible = !kEnableScissor || !scissorPixel(x + _a, y);
+	if (visible && kStencilEnabled) {
+		visible = stencilTest(ps[_a]);
+		if (!visible) {
 			stencilOp(false, true, ps + _a);
-			return;
 		}
 	}
-	bool depthTestResult;
-	if (kDepthTestEnabled) {
-		depthTestResult = compareDepth(z, pz[_a]);
-	} else {
-		depthTestResult = true;
-	}
-	if (kStencilEnabled) {
-		stencilOp(true, depthTestResult, ps + _a);
+	bool depthTestResult = false;
+	if (visible) {
+		if (kDepthTestEnabled) {
+			depthTestResult = compareDepth(z, pz[_a]);
+		} else {
+			depthTestResult = true;
+		}
+		if (kStencilEnabled) {
+			stencilOp(true, depthTestResult, ps + _a);
+		}
 	}
 	if (kDepthWrite && depthTestResult) {
 		pz[_a] = z;
@@ -279,6 +347,34 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		polyOffset = -m * _offsetFactor + -_offsetUnits * (1 << 6);
 	}
 
+	if (kInterpZ && (kDepthTestEnabled || kDepthWrite)) {
+		Common::Rect bounds(MIN(p0->x, MIN(p1->x, p2->x)), p0->y, MAX(p0->x, MAX(p1->x, p2->x)) + 1, p2->y + 1);
+
+		// Triangles behind the depth range of all the tiles they overlap are
+		// rejected without being rasterized. Stencil operations would still
+		// have to run for their fragments, so they are always rasterized
+		// when stenciling.
+		if (kDepthTestEnabled && !kStencilEnabled) {
+			// Interpolated depths can stray from the ones of the vertices by
+			// the rounding of the gradients, at most a unit per step, and
+			// by the pixels on the edges lying slightly outside the triangle.
+			int64 margin = 4 * (bounds.width() + bounds.height()) + 2 * ((int64)ABS(dzdx) + ABS(dzdy));
+			int64 zMin = (int64)MIN(p0->z, MIN(p1->z, p2->z)) + polyOffset - margin;
+			int64 zMax = (int64)MAX(p0->z, MAX(p1->z, p2->z)) + polyOffset + margin;
+			Common::Rect area = bounds;
+			area.clip(Common::Rect(_pbufWidth, _pbufHeight));
+			if (kEnableScissor)
+				area.clip(_clipRectangle);
+			if (area.isEmpty())
+				return;
+			if (areDepthTilesHiding(area, (uint)MAX<int64>(zMin, 0), (uint)MIN<int64>(zMax, 0xFFFFFFFF)))
+				return;
+		}
+
+		if (kDepthWrite)
+			invalidateDepthTiles(bounds);
+	}
+
 	// screen coordinates
 
 	int pp1 = _pbufWidth * p0->y;
@@ -395,7 +491,15 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			// Scanlines and spans lying completely outside of the scissor
+			// rectangle are rejected as a whole instead of per pixel, which
+			// keeps rendering a frame region by region cheap.
+			const bool spanVisible = !kEnableScissor ||
+				(y >= _clipRectangle.top && y < _clipRectangle.bottom &&
+				 x1 < _clipRectangle.right && (x2 >> 16) >= _clipRectangle.left);
+			if (!spanVisible) {
+				// Only the edges need to be stepped below
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -409,6 +513,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					ps = ps1 + x1;
 				}
 				while (n >= 3) {
+#ifdef SCUMMVM_SIMD
+					if (kDepthTestEnabled && !kStencilEnabled && kInterpZ &&
+					    depthTestRejects4(_depthFunc, z, dzdx, pz)) {
+						z += 4 * dzdx;
+						pz += 4;
+						n -= 4;
+						x += 4;
+						continue;
+					}
+#endif
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 0, x, y, z, dzdx);
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 1, x, y, z, dzdx);
 					putPixelDepth<kDepthWrite, kEnableScissor, kStencilEnabled, kDepthTestEnabled>(pz, ps, 2, x, y, z, dzdx);
@@ -452,6 +566,25 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					ps = ps1 + x1;
 				}
 				while (n >= 3) {
+#ifdef SCUMMVM_SIMD
+					// Groups hidden behind what has been drawn already only
+					// need their interpolants to be stepped
+					if (kDepthTestEnabled && !kStencilEnabled && kInterpZ &&
+					    depthTestRejects4(_depthFunc, z, dzdx, pz)) {
+						z += 4 * dzdx;
+						if (kSmoothMode) {
+							r += 4 * drdx;
+							g += 4 * dgdx;
+							b += 4 * dbdx;
+							a += 4 * dadx;
+						}
+						pp += 4;
+						pz += 4;
+						n -= 4;
+						x += 4;
+						continue;
+					}
+#endif
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 1, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>(pp, pz, ps, 2, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx);
@@ -517,6 +650,22 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
+#ifdef SCUMMVM_SIMD
+					if (kDepthTestEnabled && !kStencilEnabled && kInterpZ &&
+					    depthTestRejects4(_depthFunc, z, dzdx, pz) &&
+					    depthTestRejects4(_depthFunc, z + 4 * dzdx, dzdx, pz + 4)) {
+						// No texel needs to be fetched for a hidden group
+						z += NB_INTERP * dzdx;
+						s += NB_INTERP * dsdx;
+						t += NB_INTERP * dtdx;
+						if (kSmoothMode) {
+							a += NB_INTERP * dadx;
+							r += NB_INTERP * drdx;
+							g += NB_INTERP * dgdx;
+							b += NB_INTERP * dbdx;
+						}
+					} else
+#endif
 					for (int _a = 0; _a < NB_INTERP; _a++) {
 						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
@@ -1481,6 +1481,19 @@ void ThemeEngine::updateScreen() {
 #endif
 }
 
+/**
+ * Overlapping dirty rects are only worth merging when their bounding box does
+ * not cover more pixels than the two rects copied on their own. Otherwise,
+ * e.g. for a row and a column crossing each other, the merged rect would copy
+ * far more unchanged pixels than the overlap saves.
+ */
+static bool shouldMergeDirtyRects(const Common::Rect &a, const Common::Rect &b) {
+	Common::Rect bounds(a);
+	bounds.extend(b);
+
+	return bounds.width() * bounds.height() <= a.width() * a.height() + b.width() * b.height();
+}
+
 void ThemeEngine::addDirtyRect(Common::Rect r) {
 	// Clip the rect to screen coords
 	r.clip(_screen.w, _screen.h);
@@ -1499,10 +1512,19 @@ void ThemeEngine::addDirtyRect(Common::Rect r) {
 
 		// Conversely, if we find rectangles which are contained in
 		// the new one, we can remove them
-		if (r.contains(*it))
+		if (r.contains(*it)) {
 			it = _dirtyScreen.erase(it);
-		else
+		} else if (r.intersects(*it) && shouldMergeDirtyRects(r, *it)) {
+			// Overlapping rectangles get merged, so that the same pixels
+			// are not copied to the overlay several times. The grown
+			// rectangle may now overlap entries we already checked, so
+			// start over.
+			r.extend(*it);
+			_dirtyScreen.erase(it);
+			it = _dirtyScreen.begin();
+		} else {
 			++it;
+		}
 	}
 
 	// If we got here, we can safely add r to the list of dirty rects.
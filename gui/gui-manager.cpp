@@ -344,6 +344,9 @@ void GuiManager::redraw() {
 	if (_dialogStack.empty())
 		return;
 
+	const uint32 redrawStart = _system->getMillis(true);
+	const RedrawStatus redrawStatus = _redrawStatus;
+
 	shading = (ThemeEngine::ShadingStyle)xmlEval()->getVar("Dialog." + _dialogStack.top()->_name + ".Shading", 0);
 
 	// Tanoku: Do not apply shading more than once when opening many dialogs
@@ -401,6 +404,8 @@ void GuiManager::redraw() {
 
 	_theme->updateScreen();
 	_redrawStatus = kRedrawDisabled;
+
+	debug(9, "GUI: Redraw (status %d) took %u ms", redrawStatus, _system->getMillis(true) - redrawStart);
 }
 
 Dialog *GuiManager::getTopDialog() const {
@@ -40,7 +40,8 @@ MODULE_OBJS := \
 	widgets/popup.o \
 	widgets/scrollbar.o \
 	widgets/scrollcontainer.o \
-	widgets/tab.o
+	widgets/tab.o \
+	widgets/thumbnail-cache.o
 
 ifdef USE_CLOUD
 ifdef USE_LIBCURL
@@ -332,8 +332,12 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 
 #pragma mark -
 
+// Maximum number of thumbnails kept in memory. The visible ones are kept
+// even beyond it.
+static const uint kMaxLoadedThumbnails = 256;
+
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
-	: ContainerWidget(boss, name), CommandSender(boss) {
+	: ContainerWidget(boss, name), CommandSender(boss), _thumbnails(kMaxLoadedThumbnails) {
 	_thumbnailHeight = g_gui.xmlEval()->getVar("Globals.GridItemThumbnail.Height");
 	_thumbnailWidth = g_gui.xmlEval()->getVar("Globals.GridItemThumbnail.Width");
 	_flagIconHeight = g_gui.xmlEval()->getVar("Globals.Grid.FlagIcon.Height");
@@ -379,7 +383,6 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 GridWidget::~GridWidget() {
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
-	unloadSurfaces(_loadedSurfaces);
 	_gridItems.clear();
 	_dataEntryList.clear();
 	_sortedEntryList.clear();
@@ -397,7 +400,7 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+	return _thumbnails.get(name);
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
@@ -570,12 +573,14 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
+	_thumbnails.beginUpdate();
+
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
+		if (!_thumbnails.markVisible(entry->thumbPath)) {
 			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
 			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
 			if (!surf) {
@@ -585,16 +590,18 @@ void GridWidget::reloadThumbnails() {
 
 			if (surf) {
 				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, _thumbnailWidth, 512, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+				_thumbnails.add(entry->thumbPath, scSurf);
 				if (surf != scSurf) {
 					surf->free();
 					delete surf;
 				}
 			} else {
-				_loadedSurfaces[entry->thumbPath] = nullptr;
+				_thumbnails.add(entry->thumbPath, nullptr);
 			}
 		}
 	}
+
+	_thumbnails.unloadUnused();
 }
 
 void GridWidget::loadFlagIcons() {
@@ -824,7 +831,7 @@ void GridWidget::reflowLayout() {
 	_thumbnailHeight = g_gui.xmlEval()->getVar("Globals.GridItemThumbnail.Height");
 	_thumbnailWidth = g_gui.xmlEval()->getVar("Globals.GridItemThumbnail.Width");
 	if ((oldThumbnailHeight != _thumbnailHeight) || (oldThumbnailWidth != _thumbnailWidth)) {
-		unloadSurfaces(_loadedSurfaces);
+		_thumbnails.clear();
 		reloadThumbnails();
 		loadFlagIcons();
 	}
@@ -24,6 +24,7 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
+#include "gui/widgets/thumbnail-cache.h"
 #include "common/str.h"
 
 #include "image/bmp.h"
@@ -100,7 +101,7 @@ protected:
 	Common::HashMap<int, const Graphics::ManagedSurface *> _languageIcons;
 
 	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	ThumbnailCache _thumbnails;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_sortedEntryList;
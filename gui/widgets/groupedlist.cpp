@@ -49,6 +49,7 @@ void GroupedListWidget::setList(const Common::U32StringArray &list, const ColorL
 	// Copy everything
 	_dataList = list;
 	_list = list;
+	_lowercaseList.clear();
 
 	_filter.clear();
 	_listIndex.clear();
@@ -453,19 +454,18 @@ void GroupedListWidget::setFilter(const Common::U32String &filter, bool redraw)
 		// as substrings, ignoring case.
 
 		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
 		int n = 0;
 
 		_list.clear();
 		_listIndex.clear();
 
+		updateLowercaseList();
+
 		for (Common::U32StringArray::iterator i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = *i;
-			tmp.toLowercase();
 			bool matches = true;
 			tok.reset();
 			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
+				if (!_filterMatcher(_filterMatcherArg, n, _lowercaseList[n], tok.nextToken())) {
 					matches = false;
 					break;
 				}
@@ -181,6 +181,7 @@ void ListWidget::setList(const Common::U32StringArray &list, const ColorList *co
 	// Copy everything
 	_dataList = list;
 	_list = list;
+	_lowercaseList.clear();
 	_filter.clear();
 	_listIndex.clear();
 	_listColors.clear();
@@ -222,6 +223,17 @@ void ListWidget::append(const Common::String &s, ThemeEngine::FontColor color) {
 	scrollBarRecalc();
 }
 
+void ListWidget::updateLowercaseList() {
+	// Entries are only ever appended to _dataList between calls to
+	// setList(), so only the new ones need converting. This way typing in
+	// the search box does not lowercase the whole list on every keystroke.
+	for (uint i = _lowercaseList.size(); i < _dataList.size(); ++i) {
+		Common::U32String tmp = _dataList[i];
+		tmp.toLowercase();
+		_lowercaseList.push_back(tmp);
+	}
+}
+
 void ListWidget::scrollTo(int item) {
 	int size = _list.size();
 	if (item >= size)
@@ -769,19 +781,18 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
 
 		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
 		int n = 0;
 
 		_list.clear();
 		_listIndex.clear();
 
+		updateLowercaseList();
+
 		for (Common::U32StringArray::iterator i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = *i;
-			tmp.toLowercase();
 			bool matches = true;
 			tok.reset();
 			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
+				if (!_filterMatcher(_filterMatcherArg, n, _lowercaseList[n], tok.nextToken())) {
 					matches = false;
 					break;
 				}
@@ -54,6 +54,7 @@ public:
 protected:
 	Common::U32StringArray	_list;
 	Common::U32StringArray	_dataList;
+	Common::U32StringArray	_lowercaseList; ///< Lowercase copy of _dataList, used for filtering
 	ColorList		_listColors;
 	Common::Array<int>	_listIndex;
 	bool			_editable;
@@ -149,6 +150,7 @@ protected:
 	/// Finds the item at position (x,y). Returns -1 if there is no item there.
 	int findItem(int x, int y) const;
 	void scrollBarRecalc();
+	void updateLowercaseList();
 
 	void abortEditMode() override;
 
@@ -0,0 +1,95 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "graphics/managed_surface.h"
+
+#include "gui/widgets/thumbnail-cache.h"
+
+namespace GUI {
+
+ThumbnailCache::ThumbnailCache(uint maxSize) : _maxSize(maxSize), _update(0) {
+}
+
+ThumbnailCache::~ThumbnailCache() {
+	clear();
+}
+
+void ThumbnailCache::beginUpdate() {
+	_update++;
+}
+
+bool ThumbnailCache::markVisible(const Common::String &name) {
+	Common::HashMap<Common::String, Entry>::iterator entry = _entries.find(name);
+	if (entry == _entries.end())
+		return false;
+
+	entry->_value.lastUpdate = _update;
+	_useOrder.erase(entry->_value.use);
+	_useOrder.push_front(name);
+	entry->_value.use = _useOrder.begin();
+	return true;
+}
+
+void ThumbnailCache::add(const Common::String &name, const Graphics::ManagedSurface *surface) {
+	Common::HashMap<Common::String, Entry>::iterator existing = _entries.find(name);
+	if (existing != _entries.end()) {
+		delete existing->_value.surface;
+		_useOrder.erase(existing->_value.use);
+	}
+
+	_useOrder.push_front(name);
+
+	Entry &entry = _entries[name];
+	entry.surface = surface;
+	entry.lastUpdate = _update;
+	entry.use = _useOrder.begin();
+}
+
+void ThumbnailCache::unloadUnused() {
+	while (_entries.size() > _maxSize) {
+		// Everything left was visible in this update
+		const Common::String name = _useOrder.back();
+		Entry &entry = _entries[name];
+		if (entry.lastUpdate == _update)
+			break;
+
+		// Grid items copy the surface when they are updated, so nothing
+		// references it anymore
+		delete entry.surface;
+		_entries.erase(name);
+		_useOrder.pop_back();
+	}
+}
+
+void ThumbnailCache::clear() {
+	for (Common::HashMap<Common::String, Entry>::iterator i = _entries.begin(); i != _entries.end(); ++i)
+		delete i->_value.surface;
+
+	_entries.clear();
+	_useOrder.clear();
+}
+
+const Graphics::ManagedSurface *ThumbnailCache::get(const Common::String &name) const {
+	Common::HashMap<Common::String, Entry>::const_iterator entry = _entries.find(name);
+	return entry != _entries.end() ? entry->_value.surface : nullptr;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_WIDGETS_THUMBNAIL_CACHE_H
+#define GUI_WIDGETS_THUMBNAIL_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/str.h"
+
+namespace Graphics {
+class ManagedSurface;
+}
+
+namespace GUI {
+
+/**
+ * Thumbnails loaded by the grid, by file name. Beyond a maximum number of
+ * thumbnails, the least recently visible ones are unloaded, so that
+ * scrolling through a large library does not keep every icon in memory.
+ */
+class ThumbnailCache {
+public:
+	ThumbnailCache(uint maxSize);
+	~ThumbnailCache();
+
+	/**
+	 * Start a new update of the visible thumbnails, after which
+	 * markVisible() and add() are called for each of them.
+	 */
+	void beginUpdate();
+
+	/**
+	 * Mark a thumbnail as visible in the current update.
+	 *
+	 * @return Whether the thumbnail is loaded.
+	 */
+	bool markVisible(const Common::String &name);
+
+	/**
+	 * Add a thumbnail loaded for the current update, which takes ownership
+	 * of the surface. The surface is null for thumbnails which do not exist.
+	 */
+	void add(const Common::String &name, const Graphics::ManagedSurface *surface);
+
+	/**
+	 * Unload the least recently visible thumbnails, until no more than the
+	 * maximum number are loaded. The thumbnails visible in the current update
+	 * are never unloaded, even when there are more of them.
+	 */
+	void unloadUnused();
+
+	/** Unload all the thumbnails. */
+	void clear();
+
+	bool contains(const Common::String &name) const { return _entries.contains(name); }
+	const Graphics::ManagedSurface *get(const Common::String &name) const;
+	uint size() const { return _entries.size(); }
+
+private:
+	typedef Common::List<Common::String> UseList;
+
+	struct Entry {
+		const Graphics::ManagedSurface *surface;
+		uint32 lastUpdate;
+		UseList::iterator use;
+	};
+
+	Common::HashMap<Common::String, Entry> _entries;
+	// Names of the loaded thumbnails, the most recently visible first
+	UseList _useOrder;
+	uint _maxSize;
+	uint32 _update;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -56,75 +56,47 @@ inline uint16 createDitherTableIndex(const byte *clipTable, byte y, int8 u, int8
 	       ((b & 0xF0) >> 4);
 }
 
-/**
- * Put a raw pixel to the destination surface
- */
-template<typename PixelInt>
-inline void putPixelRaw(PixelInt *dst, const byte *clipTable, const Graphics::PixelFormat &format, byte y, byte u, byte v) {
-	*dst = convertYUVToColor(clipTable, format, y, u, v);
-}
-
-/**
- * Specialized putPixelRaw for palettized 8bpp output
- */
-template<>
-inline void putPixelRaw(byte *dst, const byte *clipTable, const Graphics::PixelFormat &format, byte y, byte u, byte v) {
-	*dst = y;
-}
-
 /**
  * The default codebook converter: raw output.
+ *
+ * The colors of the codebooks are converted to the output format when the
+ * codebooks are loaded, see CinepakDecoder::convertCodebook().
  */
 struct CodebookConverterRaw {
 	template<typename PixelInt>
 	static inline void decodeBlock1(byte codebookIndex, const CinepakStrip &strip, PixelInt *(&rows)[4], const byte *clipTable, const byte *colorMap, const Graphics::PixelFormat &format) {
-		const CinepakCodebook &codebook = strip.v1_codebook[codebookIndex];
-		putPixelRaw(rows[0] + 0, clipTable, format, codebook.y[0], codebook.u, codebook.v);
-		putPixelRaw(rows[0] + 1, clipTable, format, codebook.y[0], codebook.u, codebook.v);
-		putPixelRaw(rows[1] + 0, clipTable, format, codebook.y[0], codebook.u, codebook.v);
-		putPixelRaw(rows[1] + 1, clipTable, format, codebook.y[0], codebook.u, codebook.v);
-
-		putPixelRaw(rows[0] + 2, clipTable, format, codebook.y[1], codebook.u, codebook.v);
-		putPixelRaw(rows[0] + 3, clipTable, format, codebook.y[1], codebook.u, codebook.v);
-		putPixelRaw(rows[1] + 2, clipTable, format, codebook.y[1], codebook.u, codebook.v);
-		putPixelRaw(rows[1] + 3, clipTable, format, codebook.y[1], codebook.u, codebook.v);
-
-		putPixelRaw(rows[2] + 0, clipTable, format, codebook.y[2], codebook.u, codebook.v);
-		putPixelRaw(rows[2] + 1, clipTable, format, codebook.y[2], codebook.u, codebook.v);
-		putPixelRaw(rows[3] + 0, clipTable, format, codebook.y[2], codebook.u, codebook.v);
-		putPixelRaw(rows[3] + 1, clipTable, format, codebook.y[2], codebook.u, codebook.v);
-
-		putPixelRaw(rows[2] + 2, clipTable, format, codebook.y[3], codebook.u, codebook.v);
-		putPixelRaw(rows[2] + 3, clipTable, format, codebook.y[3], codebook.u, codebook.v);
-		putPixelRaw(rows[3] + 2, clipTable, format, codebook.y[3], codebook.u, codebook.v);
-		putPixelRaw(rows[3] + 3, clipTable, format, codebook.y[3], codebook.u, codebook.v);
+		const uint32 *pixels = strip.v1_pixels + (codebookIndex << 2);
+		rows[0][0] = rows[0][1] = rows[1][0] = rows[1][1] = pixels[0];
+		rows[0][2] = rows[0][3] = rows[1][2] = rows[1][3] = pixels[1];
+		rows[2][0] = rows[2][1] = rows[3][0] = rows[3][1] = pixels[2];
+		rows[2][2] = rows[2][3] = rows[3][2] = rows[3][3] = pixels[3];
 	}
 
 	template<typename PixelInt>
 	static inline void decodeBlock4(const byte (&codebookIndex)[4], const CinepakStrip &strip, PixelInt *(&rows)[4], const byte *clipTable, const byte *colorMap, const Graphics::PixelFormat &format) {
-		const CinepakCodebook &codebook1 = strip.v4_codebook[codebookIndex[0]];
-		putPixelRaw(rows[0] + 0, clipTable, format, codebook1.y[0], codebook1.u, codebook1.v);
-		putPixelRaw(rows[0] + 1, clipTable, format, codebook1.y[1], codebook1.u, codebook1.v);
-		putPixelRaw(rows[1] + 0, clipTable, format, codebook1.y[2], codebook1.u, codebook1.v);
-		putPixelRaw(rows[1] + 1, clipTable, format, codebook1.y[3], codebook1.u, codebook1.v);
-
-		const CinepakCodebook &codebook2 = strip.v4_codebook[codebookIndex[1]];
-		putPixelRaw(rows[0] + 2, clipTable, format, codebook2.y[0], codebook2.u, codebook2.v);
-		putPixelRaw(rows[0] + 3, clipTable, format, codebook2.y[1], codebook2.u, codebook2.v);
-		putPixelRaw(rows[1] + 2, clipTable, format, codebook2.y[2], codebook2.u, codebook2.v);
-		putPixelRaw(rows[1] + 3, clipTable, format, codebook2.y[3], codebook2.u, codebook2.v);
-
-		const CinepakCodebook &codebook3 = strip.v4_codebook[codebookIndex[2]];
-		putPixelRaw(rows[2] + 0, clipTable, format, codebook3.y[0], codebook3.u, codebook3.v);
-		putPixelRaw(rows[2] + 1, clipTable, format, codebook3.y[1], codebook3.u, codebook3.v);
-		putPixelRaw(rows[3] + 0, clipTable, format, codebook3.y[2], codebook3.u, codebook3.v);
-		putPixelRaw(rows[3] + 1, clipTable, format, codebook3.y[3], codebook3.u, codebook3.v);
-
-		const CinepakCodebook &codebook4 = strip.v4_codebook[codebookIndex[3]];
-		putPixelRaw(rows[2] + 2, clipTable, format, codebook4.y[0], codebook4.u, codebook4.v);
-		putPixelRaw(rows[2] + 3, clipTable, format, codebook4.y[1], codebook4.u, codebook4.v);
-		putPixelRaw(rows[3] + 2, clipTable, format, codebook4.y[2], codebook4.u, codebook4.v);
-		putPixelRaw(rows[3] + 3, clipTable, format, codebook4.y[3], codebook4.u, codebook4.v);
+		const uint32 *pixels = strip.v4_pixels + (codebookIndex[0] << 2);
+		rows[0][0] = pixels[0];
+		rows[0][1] = pixels[1];
+		rows[1][0] = pixels[2];
+		rows[1][1] = pixels[3];
+
+		pixels = strip.v4_pixels + (codebookIndex[1] << 2);
+		rows[0][2] = pixels[0];
+		rows[0][3] = pixels[1];
+		rows[1][2] = pixels[2];
+		rows[1][3] = pixels[3];
+
+		pixels = strip.v4_pixels + (codebookIndex[2] << 2);
+		rows[2][0] = pixels[0];
+		rows[2][1] = pixels[1];
+		rows[3][0] = pixels[2];
+		rows[3][1] = pixels[3];
+
+		pixels = strip.v4_pixels + (codebookIndex[3] << 2);
+		rows[2][2] = pixels[0];
+		rows[2][3] = pixels[1];
+		rows[3][2] = pixels[2];
+		rows[3][3] = pixels[3];
 	}
 };
 
@@ -438,6 +410,9 @@ const Graphics::Surface *CinepakDecoder::decodeFrame(Common::SeekableReadStream
 				_curFrame.strips[i].v4_codebook[j] = _curFrame.strips[i - 1].v4_codebook[j];
 			}
 
+			memcpy(_curFrame.strips[i].v1_pixels, _curFrame.strips[i - 1].v1_pixels, 256 * 4 * sizeof(uint32));
+			memcpy(_curFrame.strips[i].v4_pixels, _curFrame.strips[i - 1].v4_pixels, 256 * 4 * sizeof(uint32));
+
 			// Copy the QuickTime dither tables
 			memcpy(_curFrame.strips[i].v1_dither, _curFrame.strips[i - 1].v1_dither, 256 * 4 * 4 * 4);
 			memcpy(_curFrame.strips[i].v4_dither, _curFrame.strips[i - 1].v4_dither, 256 * 4 * 4 * 4);
@@ -513,6 +488,8 @@ void CinepakDecoder::initializeCodebook(uint16 strip, byte codebookType) {
 
 		if (_ditherType == kDitherTypeQT)
 			ditherCodebookQT(strip, codebookType, i);
+		else if (!_ditherPalette)
+			convertCodebook(strip, codebookType, i);
 	}
 }
 
@@ -549,9 +526,12 @@ void CinepakDecoder::loadCodebook(Common::SeekableReadStream &stream, uint16 str
 				codebook[i].v = 0;
 			}
 
-			// Dither the codebook if we're dithering for QuickTime
+			// Dither the codebook if we're dithering for QuickTime,
+			// else convert it to the output format
 			if (_ditherType == kDitherTypeQT)
 				ditherCodebookQT(strip, codebookType, i);
+			else if (!_ditherPalette)
+				convertCodebook(strip, codebookType, i);
 		}
 	}
 }
@@ -614,6 +594,19 @@ void CinepakDecoder::ditherCodebookQT(uint16 strip, byte codebookType, uint16 co
 	}
 }
 
+void CinepakDecoder::convertCodebook(uint16 strip, byte codebookType, uint16 codebookIndex) {
+	const CinepakCodebook &codebook = (codebookType == 1) ? _curFrame.strips[strip].v1_codebook[codebookIndex] : _curFrame.strips[strip].v4_codebook[codebookIndex];
+	uint32 *output = ((codebookType == 1) ? _curFrame.strips[strip].v1_pixels : _curFrame.strips[strip].v4_pixels) + (codebookIndex << 2);
+
+	for (int i = 0; i < 4; i++) {
+		// Palettized video uses the luma as the palette index
+		if (_pixelFormat.bytesPerPixel == 1)
+			output[i] = codebook.y[i];
+		else
+			output[i] = convertYUVToColor(_clipTable, _pixelFormat, codebook.y[i], codebook.u, codebook.v);
+	}
+}
+
 void CinepakDecoder::decodeVectors(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize) {
 	if (_curFrame.surface->format.bytesPerPixel == 1) {
 		decodeVectorsTmpl<byte, CodebookConverterRaw>(_curFrame, _clipTable, _colorMap, stream, strip, chunkID, chunkSize);
@@ -45,6 +45,7 @@ struct CinepakStrip {
 	uint16 length;
 	Common::Rect rect;
 	CinepakCodebook v1_codebook[256], v4_codebook[256];
+	uint32 v1_pixels[256 * 4], v4_pixels[256 * 4]; // The codebooks converted to the output format
 	byte v1_dither[256 * 4 * 4 * 4], v4_dither[256 * 4 * 4 * 4];
 };
 
@@ -100,6 +101,7 @@ private:
 	byte findNearestRGB(int index) const;
 	void ditherVectors(Common::SeekableReadStream &stream, uint16 strip, byte chunkID, uint32 chunkSize);
 	void ditherCodebookQT(uint16 strip, byte codebookType, uint16 codebookIndex);
+	void convertCodebook(uint16 strip, byte codebookType, uint16 codebookIndex);
 };
 
 } // End of namespace Image
@@ -38,6 +38,8 @@ namespace Image {
 MPEGDecoder::MPEGDecoder() : Codec() {
 	_pixelFormat = g_system->getScreenFormat();
 	_surface = 0;
+	_displayBuffer = 0;
+	_displayWidth = _displayHeight = _displayPitch = _displayChromaPitch = 0;
 
 	_mpegDecoder = mpeg2_init();
 
@@ -50,6 +52,9 @@ MPEGDecoder::MPEGDecoder() : Codec() {
 MPEGDecoder::~MPEGDecoder() {
 	mpeg2_close(_mpegDecoder);
 
+	for (uint i = 0; i < _frameBuffers.size(); i++)
+		delete _frameBuffers[i];
+
 	if (_surface) {
 		_surface->free();
 		delete _surface;
@@ -63,6 +68,48 @@ const Graphics::Surface *MPEGDecoder::decodeFrame(Common::SeekableReadStream &st
 }
 
 bool MPEGDecoder::decodePacket(Common::SeekableReadStream &packet, uint32 &framePeriod, Graphics::Surface *dst) {
+	return parsePacket(packet, framePeriod, dst, false);
+}
+
+bool MPEGDecoder::decodePacketPlanes(Common::SeekableReadStream &packet, uint32 &framePeriod) {
+	return parsePacket(packet, framePeriod, 0, true);
+}
+
+bool MPEGDecoder::convertFrame(Graphics::Surface &dst) {
+	if (!_displayBuffer)
+		return false;
+
+	YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _displayPlanes[0], _displayPlanes[1], _displayPlanes[2],
+			_displayWidth, _displayHeight, _displayPitch, _displayChromaPitch);
+	return true;
+}
+
+void MPEGDecoder::setFrameBuffer() {
+	const mpeg2_sequence_t *sequence = _mpegInfo->sequence;
+	const uint32 lumaSize = sequence->width * sequence->height;
+	const uint32 chromaSize = sequence->chroma_width * sequence->chroma_height;
+
+	// Neither libmpeg2 nor the frame still to be converted may be using it
+	FrameBuffer *frameBuffer = 0;
+	for (uint i = 0; i < _frameBuffers.size() && !frameBuffer; i++) {
+		if (!_frameBuffers[i]->decoding && _frameBuffers[i] != _displayBuffer)
+			frameBuffer = _frameBuffers[i];
+	}
+
+	if (!frameBuffer) {
+		frameBuffer = new FrameBuffer();
+		_frameBuffers.push_back(frameBuffer);
+	}
+
+	frameBuffer->data.resize(lumaSize + chromaSize * 2);
+	frameBuffer->decoding = true;
+
+	byte *data = frameBuffer->data.data();
+	uint8 *planes[3] = { data, data + lumaSize, data + lumaSize + chromaSize };
+	mpeg2_set_buf(_mpegDecoder, planes, frameBuffer);
+}
+
+bool MPEGDecoder::parsePacket(Common::SeekableReadStream &packet, uint32 &framePeriod, Graphics::Surface *dst, bool keepPlanes) {
 	// Decode as much as we can out of this packet
 	uint32 size = 0xFFFFFFFF;
 	mpeg2_state_t state;
@@ -77,9 +124,23 @@ bool MPEGDecoder::decodePacket(Common::SeekableReadStream &packet, uint32 &frame
 			size = packet.read(_buffer, BUFFER_SIZE);
 			mpeg2_buffer(_mpegDecoder, _buffer, _buffer + size);
 			break;
+		case STATE_SEQUENCE:
+			// libmpeg2 takes a buffer for each of the two reference frames,
+			// and one for each picture it decodes
+			mpeg2_custom_fbuf(_mpegDecoder, 1);
+			setFrameBuffer();
+			setFrameBuffer();
+			break;
+		case STATE_PICTURE:
+			setFrameBuffer();
+			break;
 		case STATE_SLICE:
 		case STATE_END:
-			if (_mpegInfo->display_fbuf) {
+		case STATE_INVALID_END:
+			if (_mpegInfo->discard_fbuf)
+				((FrameBuffer *)_mpegInfo->discard_fbuf->id)->decoding = false;
+
+			if (state != STATE_INVALID_END && _mpegInfo->display_fbuf) {
 				foundFrame = true;
 				const mpeg2_sequence_t *sequence = _mpegInfo->sequence;
 				const mpeg2_picture_t *picture = _mpegInfo->display_picture;
@@ -90,6 +151,18 @@ bool MPEGDecoder::decodePacket(Common::SeekableReadStream &packet, uint32 &frame
 
 				}
 
+				// The buffer is not given back to libmpeg2 before the next frame
+				_displayBuffer = (const FrameBuffer *)_mpegInfo->display_fbuf->id;
+				for (int i = 0; i < 3; i++)
+					_displayPlanes[i] = _mpegInfo->display_fbuf->buf[i];
+				_displayWidth = sequence->picture_width;
+				_displayHeight = sequence->picture_height;
+				_displayPitch = sequence->width;
+				_displayChromaPitch = sequence->chroma_width;
+
+				if (keepPlanes)
+					break;
+
 				if (!dst) {
 					// If no destination is specified, use our internal storage
 					if (!_surface) {
@@ -100,9 +173,7 @@ bool MPEGDecoder::decodePacket(Common::SeekableReadStream &packet, uint32 &frame
 					dst = _surface;
 				}
 
-				YUVToRGBMan.convert420(dst, Graphics::YUVToRGBManager::kScaleITU, _mpegInfo->display_fbuf->buf[0],
-						_mpegInfo->display_fbuf->buf[1], _mpegInfo->display_fbuf->buf[2], sequence->picture_width,
-						sequence->picture_height, sequence->width, sequence->chroma_width);
+				convertFrame(*dst);
 			}
 			break;
 		default:
@@ -24,6 +24,7 @@
 #ifndef IMAGE_CODECS_MPEG_H
 #define IMAGE_CODECS_MPEG_H
 
+#include "common/array.h"
 #include "image/codecs/codec.h"
 #include "graphics/pixelformat.h"
 
@@ -54,13 +55,37 @@ public:
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
 	Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
 
-	// MPEGPSDecoder call
+	// MPEGPSDecoder calls
 	bool decodePacket(Common::SeekableReadStream &packet, uint32 &framePeriod, Graphics::Surface *dst = 0);
 
+	/**
+	 * Decode a packet without converting the last frame in it. The frame
+	 * is converted by convertFrame(), once it is known which surface it is
+	 * needed in.
+	 */
+	bool decodePacketPlanes(Common::SeekableReadStream &packet, uint32 &framePeriod);
+	bool convertFrame(Graphics::Surface &dst);
+
 private:
 	Graphics::PixelFormat _pixelFormat;
 	Graphics::Surface *_surface;
 
+	// libmpeg2 decodes to frame buffers allocated here, so that the last
+	// frame is not given back to it before convertFrame() is called
+	struct FrameBuffer {
+		Common::Array<byte> data;
+		bool decoding;
+	};
+
+	Common::Array<FrameBuffer *> _frameBuffers;
+	const FrameBuffer *_displayBuffer;
+	const byte *_displayPlanes[3];
+	int _displayWidth, _displayHeight, _displayPitch, _displayChromaPitch;
+
+	void setFrameBuffer();
+
+	bool parsePacket(Common::SeekableReadStream &packet, uint32 &framePeriod, Graphics::Surface *dst, bool keepPlanes);
+
 	enum {
 		BUFFER_SIZE = 4096
 	};
@@ -0,0 +1,108 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/memstream.h"
+#include "common/str.h"
+#include "common/tokenizer.h"
+
+#include "backends/graphics/null/null-checksum-graphics.h"
+
+class NullChecksumGraphicsTestSuite : public CxxTest::TestSuite {
+	struct Frame {
+		uint number;
+		uint milliseconds;
+		Common::String checksum;
+	};
+
+	// Parses the lines written so far, checking that they are well formed
+	static Common::Array<Frame> readFrames(Common::MemoryWriteStreamDynamic *stream) {
+		Common::String csv((const char *)stream->getData(), stream->size());
+		Common::StringTokenizer lines(csv, "\n");
+		Common::Array<Frame> frames;
+
+		TS_ASSERT_EQUALS(lines.nextToken(), "frame,milliseconds,checksum");
+		while (!lines.empty()) {
+			Common::StringTokenizer fields(lines.nextToken(), ",");
+			Frame frame;
+			frame.number = atoi(fields.nextToken().c_str());
+			frame.milliseconds = atoi(fields.nextToken().c_str());
+			frame.checksum = fields.nextToken();
+			TS_ASSERT(fields.empty());
+			TS_ASSERT_EQUALS(frame.checksum.size(), 8u);
+			frames.push_back(frame);
+		}
+		return frames;
+	}
+
+	static void fillScreen(NullChecksumGraphicsManager &graphics, byte color) {
+		byte pixels[16 * 8];
+		memset(pixels, color, sizeof(pixels));
+		graphics.copyRectToScreen(pixels, 16, 0, 0, 16, 8);
+	}
+
+public:
+	void test_one_line_per_frame() {
+		Common::MemoryWriteStreamDynamic *stream = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		NullChecksumGraphicsManager graphics(stream);
+		graphics.initSize(16, 8);
+
+		fillScreen(graphics, 1);
+		graphics.updateScreen();
+		graphics.updateScreen();
+		fillScreen(graphics, 2);
+		graphics.updateScreen();
+
+		Common::Array<Frame> frames = readFrames(stream);
+		TS_ASSERT_EQUALS(frames.size(), 3u);
+		for (uint i = 0; i < frames.size(); i++)
+			TS_ASSERT_EQUALS(frames[i].number, i);
+		TS_ASSERT_EQUALS(frames[0].milliseconds, 0u);
+
+		TS_ASSERT_EQUALS(frames[0].checksum, frames[1].checksum);
+		TS_ASSERT_DIFFERS(frames[1].checksum, frames[2].checksum);
+	}
+
+	void test_palette_changes_checksum() {
+		Common::MemoryWriteStreamDynamic *stream = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		NullChecksumGraphicsManager graphics(stream);
+		graphics.initSize(16, 8);
+
+		fillScreen(graphics, 1);
+		graphics.updateScreen();
+		const byte red[] = { 255, 0, 0 };
+		graphics.setPalette(red, 1, 1);
+		graphics.updateScreen();
+
+		Common::Array<Frame> frames = readFrames(stream);
+		TS_ASSERT_EQUALS(frames.size(), 2u);
+		TS_ASSERT_DIFFERS(frames[0].checksum, frames[1].checksum);
+	}
+
+	void test_overlay_replaces_screen() {
+		Common::MemoryWriteStreamDynamic *stream = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		NullChecksumGraphicsManager graphics(stream);
+		graphics.initSize(16, 8);
+
+		TS_ASSERT(!graphics.isOverlayVisible());
+		fillScreen(graphics, 1);
+		graphics.updateScreen();
+
+		// Changes to the game screen are hidden by the overlay
+		graphics.showOverlay();
+		TS_ASSERT(graphics.isOverlayVisible());
+		graphics.clearOverlay();
+		graphics.updateScreen();
+		fillScreen(graphics, 2);
+		graphics.updateScreen();
+
+		graphics.hideOverlay();
+		graphics.updateScreen();
+
+		Common::Array<Frame> frames = readFrames(stream);
+		TS_ASSERT_EQUALS(frames.size(), 4u);
+		TS_ASSERT_DIFFERS(frames[0].checksum, frames[1].checksum);
+		TS_ASSERT_EQUALS(frames[1].checksum, frames[2].checksum);
+		TS_ASSERT_DIFFERS(frames[2].checksum, frames[3].checksum);
+		TS_ASSERT_DIFFERS(frames[0].checksum, frames[3].checksum);
+	}
+};
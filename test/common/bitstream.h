@@ -255,4 +255,24 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	template<class MS, class BS>
+	void tmpl_get_bits_16(uint32 first, uint32 second) {
+		byte contents[] = { 0x12, 0x34, 0x56, 0x78 };
+
+		MS ms(contents, sizeof(contents));
+
+		BS bs(ms);
+		TS_ASSERT_EQUALS(bs.getBits(8), first);
+		TS_ASSERT_EQUALS(bs.getBits(16), second);
+		TS_ASSERT_EQUALS(bs.pos(), 24u);
+	}
+public:
+	void test_get_bits_16() {
+		tmpl_get_bits_16<Common::MemoryReadStream, Common::BitStream16BEMSB>(0x12u, 0x3456u);
+		tmpl_get_bits_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BEMSB>(0x12u, 0x3456u);
+		tmpl_get_bits_16<Common::MemoryReadStream, Common::BitStream16LEMSB>(0x34u, 0x1278u);
+		tmpl_get_bits_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16LEMSB>(0x34u, 0x1278u);
+	}
 };
@@ -0,0 +1,50 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fft.h"
+
+class FFTTestSuite : public CxxTest::TestSuite {
+	// Compares the FFT against a direct evaluation of the transform
+	static void checkTransform(int bits, int inverse) {
+		const int n = 1 << bits;
+		const double sign = inverse ? 1.0 : -1.0;
+
+		Common::Complex *input = new Common::Complex[n];
+		Common::Complex *output = new Common::Complex[n];
+
+		for (int i = 0; i < n; i++) {
+			input[i].re = output[i].re = (float)((i * 37 % 101) - 50) / 50.0f;
+			input[i].im = output[i].im = (float)((i * 59 % 97) - 48) / 48.0f;
+		}
+
+		Common::FFT fft(bits, inverse);
+		fft.permute(output);
+		fft.calc(output);
+
+		for (int k = 0; k < n; k++) {
+			double re = 0.0, im = 0.0;
+
+			for (int i = 0; i < n; i++) {
+				const double angle = sign * 2.0 * M_PI * ((double)i * k / n);
+				re += input[i].re * cos(angle) - input[i].im * sin(angle);
+				im += input[i].re * sin(angle) + input[i].im * cos(angle);
+			}
+
+			TS_ASSERT_DELTA(output[k].re, re, 1e-4 * n);
+			TS_ASSERT_DELTA(output[k].im, im, 1e-4 * n);
+		}
+
+		delete[] input;
+		delete[] output;
+	}
+
+public:
+	void test_forward() {
+		for (int bits = 2; bits <= 10; bits++)
+			checkTransform(bits, 0);
+	}
+
+	void test_inverse() {
+		for (int bits = 2; bits <= 10; bits++)
+			checkTransform(bits, 1);
+	}
+};
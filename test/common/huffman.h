@@ -2,15 +2,94 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/array.h"
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
 * The encoding used comes from the example on the Wikipedia page
 * for Huffman.
-* TODO: It could be improved by generating one at runtime.
 */
 class HuffmanTestSuite : public CxxTest::TestSuite {
+	/*
+	 * Builds a canonical code with lengths from 2 to 31 bits, enough
+	 * to need several levels of lookup tables, encodes a sequence of
+	 * symbols with it and checks that they are decoded again.
+	 */
+	template<class BITSTREAM>
+	static void checkLongCodes() {
+		static const uint8 lengthCounts[][2] = {
+			{ 2, 1 }, { 3, 2 }, { 9, 60 }, { 10, 3 }, { 13, 100 }, { 17, 40 }, { 24, 10 }, { 31, 4 }
+		};
+
+		Common::Array<uint32> codes, symbols;
+		Common::Array<uint8> lengths;
+
+		uint32 code = 0;
+		uint8 prevLength = 0;
+		for (uint i = 0; i < ARRAYSIZE(lengthCounts); i++) {
+			for (uint j = 0; j < lengthCounts[i][1]; j++) {
+				code <<= lengthCounts[i][0] - prevLength;
+				prevLength = lengthCounts[i][0];
+
+				// LSB first streams expect the first bit of the code in the LSB
+				if (BITSTREAM::isMSB2LSB())
+					codes.push_back(code);
+				else
+					codes.push_back(Common::REVERSEBITS(code) >> (32 - prevLength));
+
+				lengths.push_back(prevLength);
+				symbols.push_back(codes.size() * 7 + 3);
+				code++;
+			}
+		}
+
+		Common::Huffman<BITSTREAM> h(0, codes.size(), codes.data(), lengths.data(), symbols.data());
+
+		// Encode every symbol a few times, in a scrambled order
+		Common::Array<uint32> expected;
+		byte data[4096];
+		memset(data, 0, sizeof(data));
+
+		uint32 bitPos = 0;
+		for (uint i = 0; i < codes.size() * 3; i++) {
+			const uint32 index = (i * 97) % codes.size();
+			expected.push_back(symbols[index]);
+
+			for (uint8 j = 0; j < lengths[index]; j++) {
+				uint32 bit;
+				if (BITSTREAM::isMSB2LSB())
+					bit = (codes[index] >> (lengths[index] - 1 - j)) & 1;
+				else
+					bit = (codes[index] >> j) & 1;
+
+				if (BITSTREAM::isMSB2LSB())
+					data[bitPos / 8] |= bit << (7 - bitPos % 8);
+				else
+					data[bitPos / 8] |= bit << (bitPos % 8);
+
+				bitPos++;
+			}
+		}
+
+		TS_ASSERT_LESS_THAN(bitPos, sizeof(data) * 8);
+
+		Common::MemoryReadStream ms(data, sizeof(data));
+		BITSTREAM bs(ms);
+
+		for (uint i = 0; i < expected.size(); i++)
+			TS_ASSERT_EQUALS(h.getSymbol(bs), expected[i]);
+
+		TS_ASSERT_EQUALS(bs.pos(), bitPos);
+	}
+
 	public:
+	void test_long_codes() {
+		checkLongCodes<Common::BitStream8MSB>();
+		checkLongCodes<Common::BitStream8LSB>();
+		checkLongCodes<Common::BitStream32LELSB>();
+		checkLongCodes<Common::BitStream16BEMSB>();
+	}
+
 	void test_get_with_full_symbols() {
 
 		/*
@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/str.h"
+#include "common/ustr.h"
+
+#include "graphics/font.h"
+
+/**
+ * A monospaced font which counts how often the width of a character is
+ * queried, which only happens when wordWrapText() actually wraps a string.
+ */
+class WordWrapTestFont : public Graphics::Font {
+public:
+	WordWrapTestFont(bool cached) : _widthQueries(0) {
+		setWordWrapCacheEnabled(cached);
+	}
+
+	int getFontHeight() const override { return 8; }
+	int getMaxCharWidth() const override { return 6; }
+
+	int getCharWidth(uint32 chr) const override {
+		_widthQueries++;
+		return chr == 'W' ? 10 : 6;
+	}
+
+	void drawChar(Graphics::Surface *dst, uint32 chr, int x, int y, uint32 color) const override {}
+
+	void invalidate() { invalidateWordWrapCache(); }
+
+	mutable uint _widthQueries;
+};
+
+class FontTestSuite : public CxxTest::TestSuite {
+	// Number of strings the word wrap cache of a font keeps
+	static const int kCacheSize = 256;
+
+	static Common::String numberedString(int i) {
+		return Common::String::format("Entry number %d of the list", i);
+	}
+
+	// Returns whether wrapping the string had to measure it
+	static bool wrapMeasures(const WordWrapTestFont &font, const Common::String &str, int maxWidth = 60) {
+		Common::Array<Common::String> lines;
+		const uint queries = font._widthQueries;
+		font.wordWrapText(str, maxWidth, lines);
+		return font._widthQueries != queries;
+	}
+
+public:
+	void test_cached_wrap_matches_uncached() {
+		static const char *const texts[] = {
+			"",
+			"Short",
+			"A sentence long enough to be wrapped over a few lines",
+			"Explicit\nnew lines\n\nand  double  spaces",
+			"AVeryLongWordWhichDoesNotFitOnOneLineAtAll and more",
+			"WWW WWW WWW WWW WWW WWW"
+		};
+		// Even width lines need room for at least ten spaces
+		static const int widths[] = { 70, 120, 200 };
+		static const uint32 modes[] = {
+			Graphics::kWordWrapDefault,
+			Graphics::kWordWrapOnExplicitNewLines,
+			Graphics::kWordWrapEvenWidthLines | Graphics::kWordWrapOnExplicitNewLines
+		};
+
+		WordWrapTestFont cached(true), uncached(false);
+
+		// Wrap everything twice, so that the second pass hits the cache
+		for (int pass = 0; pass < 2; pass++) {
+			for (uint i = 0; i < ARRAYSIZE(texts); i++) {
+				for (uint j = 0; j < ARRAYSIZE(widths); j++) {
+					for (uint k = 0; k < ARRAYSIZE(modes); k++) {
+						for (int initWidth = 0; initWidth <= 20; initWidth += 20) {
+							Common::Array<Common::String> cachedLines, uncachedLines;
+							int cachedWidth = cached.wordWrapText(texts[i], widths[j], cachedLines, initWidth, modes[k]);
+							int uncachedWidth = uncached.wordWrapText(texts[i], widths[j], uncachedLines, initWidth, modes[k]);
+
+							TS_ASSERT_EQUALS(cachedWidth, uncachedWidth);
+							TS_ASSERT_EQUALS(cachedLines.size(), uncachedLines.size());
+							for (uint line = 0; line < MIN(cachedLines.size(), uncachedLines.size()); line++)
+								TS_ASSERT_EQUALS(cachedLines[line], uncachedLines[line]);
+
+							Common::Array<Common::U32String> cachedU32Lines, uncachedU32Lines;
+							cachedWidth = cached.wordWrapText(Common::U32String(texts[i]), widths[j], cachedU32Lines, initWidth, modes[k]);
+							uncachedWidth = uncached.wordWrapText(Common::U32String(texts[i]), widths[j], uncachedU32Lines, initWidth, modes[k]);
+
+							TS_ASSERT_EQUALS(cachedWidth, uncachedWidth);
+							TS_ASSERT_EQUALS(cachedU32Lines.size(), uncachedU32Lines.size());
+							for (uint line = 0; line < MIN(cachedU32Lines.size(), uncachedU32Lines.size()); line++)
+								TS_ASSERT_EQUALS(cachedU32Lines[line], uncachedU32Lines[line]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void test_cached_wrap_appends_lines() {
+		WordWrapTestFont font(true);
+
+		Common::Array<Common::String> lines;
+		lines.push_back("Existing");
+		font.wordWrapText("One two three four", 60, lines);
+		font.wordWrapText("One two three four", 60, lines);
+
+		TS_ASSERT_EQUALS(lines.size(), 5u);
+		TS_ASSERT_EQUALS(lines[0], "Existing");
+		TS_ASSERT_EQUALS(lines[1], "One two");
+		TS_ASSERT_EQUALS(lines[3], "One two");
+	}
+
+	void test_cache_hits() {
+		WordWrapTestFont font(true);
+
+		TS_ASSERT(wrapMeasures(font, "The same string"));
+		TS_ASSERT(!wrapMeasures(font, "The same string"));
+
+		// Each parameter is part of the key
+		TS_ASSERT(wrapMeasures(font, "The same string", 80));
+		TS_ASSERT(!wrapMeasures(font, "The same string", 80));
+		TS_ASSERT(!wrapMeasures(font, "The same string"));
+
+		Common::Array<Common::String> lines;
+		const uint queries = font._widthQueries;
+		font.wordWrapText("The same string", 60, lines, 10);
+		TS_ASSERT_DIFFERS(font._widthQueries, queries);
+
+		font.invalidate();
+		TS_ASSERT(wrapMeasures(font, "The same string"));
+	}
+
+	void test_cache_evicts_least_recently_used() {
+		WordWrapTestFont font(true);
+
+		for (int i = 0; i < kCacheSize; i++)
+			TS_ASSERT(wrapMeasures(font, numberedString(i)));
+
+		// Everything fits
+		for (int i = 0; i < kCacheSize; i++)
+			TS_ASSERT(!wrapMeasures(font, numberedString(i)));
+
+		// Use the first string again, so that the second one is now the least
+		// recently used, and make room for a new string
+		TS_ASSERT(!wrapMeasures(font, numberedString(0)));
+		TS_ASSERT(wrapMeasures(font, numberedString(kCacheSize)));
+
+		TS_ASSERT(!wrapMeasures(font, numberedString(0)));
+		TS_ASSERT(!wrapMeasures(font, numberedString(2)));
+		TS_ASSERT(!wrapMeasures(font, numberedString(kCacheSize)));
+
+		// String 1 was dropped. Adding it back drops string 3, which is now the
+		// least recently used one, as string 2 was used again above.
+		TS_ASSERT(wrapMeasures(font, numberedString(1)));
+		TS_ASSERT(!wrapMeasures(font, numberedString(1)));
+		TS_ASSERT(wrapMeasures(font, numberedString(3)));
+	}
+
+	void test_cache_disabled() {
+		WordWrapTestFont font(false);
+
+		TS_ASSERT(wrapMeasures(font, "The same string"));
+		TS_ASSERT(wrapMeasures(font, "The same string"));
+	}
+};
@@ -0,0 +1,302 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#endif
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#ifdef USE_TINYGL
+	static const int kWidth = 96;
+	static const int kHeight = 64;
+
+	// Serialized size of a vertex in a frame capture, and offset of its clip
+	// code, see TinyGL::FrameCapture
+	static const int kVertexSize = 4 + 3 * 4 + 5 * 4 * 4 + 4 + 9 * 4 + 2 * 4;
+	static const int kVertexClipCodeOffset = 4 + 3 * 4 + 5 * 4 * 4;
+
+	static void drawTriangle(const float *colors, float x0, float y0, float x1, float y1, float x2, float y2, float z) {
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(colors[0], colors[1], colors[2]);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(x0, y0, z);
+		tglColor3f(colors[3], colors[4], colors[5]);
+		tglTexCoord2f(3.0f, 0.0f);
+		tglVertex3f(x1, y1, z);
+		tglColor3f(colors[6], colors[7], colors[8]);
+		tglTexCoord2f(0.0f, 3.0f);
+		tglVertex3f(x2, y2, z);
+		tglEnd();
+	}
+
+	// Draws Gouraud shaded and textured triangles partly hidden behind a
+	// nearer one, an image, and a small square at markerX, the only thing
+	// that moves between frames
+	static void drawFrame(uint texture, TinyGL::BlitImage *image, int markerX) {
+		static const float front[] = { 0.9f, 0.1f, 0.1f, 0.1f, 0.9f, 0.1f, 0.1f, 0.1f, 0.9f };
+		static const float back[] = { 0.2f, 0.9f, 0.7f, 0.9f, 0.3f, 0.1f, 0.5f, 0.5f, 1.0f };
+		static const float white[] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+		tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		drawTriangle(front, 0.0f, 0.0f, 50.0f, 4.0f, 10.0f, 64.0f, 0.5f);
+		drawTriangle(back, 2.0f, 2.0f, 95.0f, 10.0f, 20.0f, 62.0f, -0.5f);
+
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		drawTriangle(white, 5.0f, 30.0f, 94.0f, 34.0f, 40.0f, 63.0f, -0.2f);
+		tglDisable(TGL_TEXTURE_2D);
+
+		tglDisable(TGL_DEPTH_TEST);
+		tglBlit(image, 70, 3);
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(1.0f, 1.0f, 0.0f);
+		tglVertex3f(markerX, 25.0f, 0.0f);
+		tglVertex3f(markerX + 7.0f, 25.0f, 0.0f);
+		tglVertex3f(markerX, 39.0f, 0.0f);
+		tglEnd();
+	}
+
+	static void createContext(bool dirtyRects) {
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, true, dirtyRects);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, 0, kHeight, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+	}
+
+	static uint createTexture() {
+		byte texels[4 * 4 * 4];
+		for (int i = 0; i < 4 * 4; i++) {
+			texels[i * 4 + 0] = (byte)(i * 16);
+			texels[i * 4 + 1] = (byte)(255 - i * 12);
+			texels[i * 4 + 2] = (byte)(i * 37);
+			texels[i * 4 + 3] = 255;
+		}
+		uint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_NEAREST);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 4, 4, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+		return texture;
+	}
+
+	static TinyGL::BlitImage *createImage() {
+		// A 16 bits image, which is converted when uploaded
+		Graphics::Surface surface;
+		surface.create(20, 12, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		for (int y = 0; y < surface.h; y++) {
+			for (int x = 0; x < surface.w; x++)
+				*(uint16 *)surface.getBasePtr(x, y) = (uint16)(x * 3000 + y * 41);
+		}
+
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, surface, 0, false);
+		surface.free();
+		return image;
+	}
+
+	static Graphics::Surface *copyFrame() {
+		Graphics::Surface frame;
+		TinyGL::getSurfaceRef(frame);
+		Graphics::Surface *copy = new Graphics::Surface();
+		copy->copyFrom(frame);
+		return copy;
+	}
+
+	// Renders the frames in a new context and returns a copy of the last one
+	static Graphics::Surface *renderFrames(bool dirtyRects, const int *markers, int frames) {
+		createContext(dirtyRects);
+		uint texture = createTexture();
+		TinyGL::BlitImage *image = createImage();
+
+		for (int i = 0; i < frames; i++) {
+			drawFrame(texture, image, markers[i]);
+			TinyGL::presentBuffer();
+		}
+		Graphics::Surface *frame = copyFrame();
+
+		tglDeleteBlitImage(image);
+		TinyGL::destroyContext();
+		return frame;
+	}
+
+	static int countDifferences(const Graphics::Surface *expected, const Graphics::Surface *actual) {
+		int differences = 0;
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				if (expected->getPixel(x, y) != actual->getPixel(x, y))
+					differences++;
+			}
+		}
+		return differences;
+	}
+
+	static void freeFrame(Graphics::Surface *frame) {
+		frame->free();
+		delete frame;
+	}
+
+	// Draws quads, a strip of three quads, and a triangle after them, which
+	// has fewer vertices than the strip
+	static void drawQuads() {
+		tglClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglBegin(TGL_QUADS);
+		tglColor3f(0.2f, 0.4f, 1.0f);
+		tglVertex3f(10.0f, 45.0f, 0.0f);
+		tglVertex3f(40.0f, 45.0f, 0.0f);
+		tglVertex3f(40.0f, 60.0f, 0.0f);
+		tglVertex3f(10.0f, 60.0f, 0.0f);
+		tglVertex3f(50.0f, 45.0f, 0.0f);
+		tglVertex3f(90.0f, 45.0f, 0.0f);
+		tglVertex3f(90.0f, 60.0f, 0.0f);
+		tglVertex3f(50.0f, 60.0f, 0.0f);
+		tglEnd();
+
+		tglBegin(TGL_QUAD_STRIP);
+		tglColor3f(1.0f, 1.0f, 0.0f);
+		for (int i = 0; i < 4; i++) {
+			tglVertex3f(10.0f + i * 20.0f, 20.0f, 0.0f);
+			tglVertex3f(10.0f + i * 20.0f, 40.0f, 0.0f);
+		}
+		tglEnd();
+
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(1.0f, 0.0f, 1.0f);
+		tglVertex3f(10.0f, 2.0f, 0.0f);
+		tglVertex3f(30.0f, 2.0f, 0.0f);
+		tglVertex3f(10.0f, 12.0f, 0.0f);
+		tglEnd();
+	}
+#endif
+
+public:
+	void test_scissored_spans_match_full_spans() {
+#ifdef USE_TINYGL
+		// Moving the marker only redraws the area around it, which cuts
+		// through the spans of the triangles at uneven offsets
+		static const int markers[] = { 33, 41, 58 };
+
+		Graphics::Surface *expected = renderFrames(false, markers + ARRAYSIZE(markers) - 1, 1);
+		Graphics::Surface *actual = renderFrames(true, markers, ARRAYSIZE(markers));
+
+		TS_ASSERT_EQUALS(countDifferences(expected, actual), 0);
+
+		freeFrame(expected);
+		freeFrame(actual);
+#endif
+	}
+
+	void test_unchanged_quads_are_not_redrawn() {
+#ifdef USE_TINYGL
+		createContext(true);
+
+		for (int i = 0; i < 3; i++) {
+			drawQuads();
+			Common::List<Common::Rect> dirtyAreas;
+			TinyGL::presentBuffer(dirtyAreas);
+
+			// Rendering a frame must not change its draw calls, which are
+			// compared with the next frame's
+			TS_ASSERT_EQUALS(dirtyAreas.empty(), i != 0);
+		}
+
+		// Each quad of the strip is drawn
+		Graphics::Surface frame;
+		TinyGL::getSurfaceRef(frame);
+		for (int x = 20; x < 80; x += 20)
+			TS_ASSERT_EQUALS(frame.getPixel(x, kHeight / 2), frame.format.RGBToColor(255, 255, 0));
+
+		TinyGL::destroyContext();
+#endif
+	}
+
+	void test_capture_replay() {
+#ifdef USE_TINYGL
+		createContext(false);
+		uint texture = createTexture();
+		TinyGL::BlitImage *image = createImage();
+
+		Common::MemoryWriteStreamDynamic capture(DisposeAfterUse::YES);
+		TinyGL::captureNextFrame(&capture);
+		drawFrame(texture, image, 41);
+		TinyGL::presentBuffer();
+		Graphics::Surface *expected = copyFrame();
+
+		tglDeleteBlitImage(image);
+		TinyGL::destroyContext();
+
+		// Replay in a context which has none of the textures and images
+		createContext(false);
+		Common::MemoryReadStream stream(capture.getData(), capture.size());
+		TS_ASSERT(TinyGL::replayFrame(&stream));
+		TinyGL::presentBuffer();
+		Graphics::Surface *actual = copyFrame();
+
+		TS_ASSERT_EQUALS(countDifferences(expected, actual), 0);
+
+		// Truncated captures are rejected, whichever record is cut
+		for (uint32 size = 0; size < capture.size(); size += 7) {
+			Common::MemoryReadStream truncated(capture.getData(), size);
+			TS_ASSERT(!TinyGL::replayFrame(&truncated));
+			TinyGL::presentBuffer();
+		}
+
+		TinyGL::destroyContext();
+		freeFrame(expected);
+		freeFrame(actual);
+#endif
+	}
+
+	void test_replay_rejects_offscreen_vertices() {
+#ifdef USE_TINYGL
+		createContext(false);
+
+		Common::MemoryWriteStreamDynamic capture(DisposeAfterUse::YES);
+		TinyGL::captureNextFrame(&capture);
+		tglBegin(TGL_TRIANGLES);
+		tglColor3f(1.0f, 1.0f, 1.0f);
+		tglVertex3f(10.0f, 10.0f, 0.0f);
+		tglVertex3f(20.0f, 10.0f, 0.0f);
+		tglVertex3f(10.0f, 20.0f, 0.0f);
+		tglEnd();
+		TinyGL::presentBuffer();
+
+		Common::MemoryReadStream stream(capture.getData(), capture.size());
+		TS_ASSERT(TinyGL::replayFrame(&stream));
+		TinyGL::presentBuffer();
+
+		// Move the screen coordinates of the first vertex, which is not
+		// clipped, far off screen. The vertices are the last record before
+		// the end tag, and the x coordinate follows the clip code.
+		byte *data = capture.getData();
+		uint32 vertexX = capture.size() - 4 - 3 * kVertexSize + kVertexClipCodeOffset + 4;
+		TS_ASSERT_LESS_THAN(READ_LE_UINT32(data + vertexX), (uint32)kWidth);
+		WRITE_LE_UINT32(data + vertexX, 100000);
+
+		Common::MemoryReadStream corrupted(data, capture.size());
+		TS_ASSERT(!TinyGL::replayFrame(&corrupted));
+		TinyGL::presentBuffer();
+
+		TinyGL::destroyContext();
+#endif
+	}
+};
@@ -0,0 +1,80 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/managed_surface.h"
+
+#include "gui/widgets/thumbnail-cache.h"
+
+class ThumbnailCacheTestSuite : public CxxTest::TestSuite {
+	static Common::String thumbnailName(int i) {
+		return Common::String::format("icons/engine-game%d.png", i);
+	}
+
+	// Runs an update of the visible thumbnails like GridWidget does, loading
+	// the ones which are not loaded yet
+	static void showThumbnails(GUI::ThumbnailCache &cache, int first, int last) {
+		cache.beginUpdate();
+		for (int i = first; i <= last; i++) {
+			if (!cache.markVisible(thumbnailName(i)))
+				cache.add(thumbnailName(i), new Graphics::ManagedSurface(8, 8, Graphics::PixelFormat::createFormatCLUT8()));
+		}
+		cache.unloadUnused();
+	}
+
+public:
+	void test_keeps_visible_thumbnails() {
+		GUI::ThumbnailCache cache(4);
+
+		// More thumbnails are visible than the cache holds
+		showThumbnails(cache, 0, 5);
+		TS_ASSERT_EQUALS(cache.size(), 6u);
+		for (int i = 0; i <= 5; i++)
+			TS_ASSERT(cache.get(thumbnailName(i)));
+
+		// Scrolling by two thumbnails unloads the ones which are not visible
+		// anymore, back to the limit
+		showThumbnails(cache, 2, 7);
+		TS_ASSERT_EQUALS(cache.size(), 6u);
+		TS_ASSERT(!cache.contains(thumbnailName(0)));
+		TS_ASSERT(!cache.contains(thumbnailName(1)));
+		for (int i = 2; i <= 7; i++)
+			TS_ASSERT(cache.get(thumbnailName(i)));
+	}
+
+	void test_unloads_least_recently_visible() {
+		GUI::ThumbnailCache cache(4);
+
+		showThumbnails(cache, 0, 1);
+		showThumbnails(cache, 2, 3);
+		// Scroll back up, so that 2 and 3 are now the least recently visible
+		showThumbnails(cache, 0, 1);
+		showThumbnails(cache, 4, 4);
+
+		TS_ASSERT_EQUALS(cache.size(), 4u);
+		TS_ASSERT(cache.contains(thumbnailName(0)));
+		TS_ASSERT(cache.contains(thumbnailName(1)));
+		TS_ASSERT(!cache.contains(thumbnailName(2)));
+		TS_ASSERT(cache.contains(thumbnailName(3)));
+		TS_ASSERT(cache.contains(thumbnailName(4)));
+
+		// Already loaded thumbnails are not loaded again
+		const Graphics::ManagedSurface *surface = cache.get(thumbnailName(3));
+		showThumbnails(cache, 3, 3);
+		TS_ASSERT_EQUALS(cache.get(thumbnailName(3)), surface);
+	}
+
+	void test_missing_thumbnails() {
+		GUI::ThumbnailCache cache(2);
+
+		cache.beginUpdate();
+		cache.add(thumbnailName(0), nullptr);
+		cache.unloadUnused();
+
+		// Missing thumbnails are remembered, so that they are not looked up again
+		TS_ASSERT(cache.contains(thumbnailName(0)));
+		TS_ASSERT(!cache.get(thumbnailName(0)));
+		TS_ASSERT(!cache.get(thumbnailName(1)));
+
+		cache.clear();
+		TS_ASSERT_EQUALS(cache.size(), 0u);
+	}
+};
@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/gui/*.h $(srcdir)/test/video/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -28,7 +28,14 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+# The GUI and backend code depends on the whole GUI or backend, so only the
+# parts under test are linked in
+TESTS +=	$(srcdir)/test/backends/*.h
+TEST_LIBS +=	gui/widgets/thumbnail-cache.o \
+	backends/graphics/null/null-checksum-graphics.o \
+	backends/mixer/null/null-mixer.o
+
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
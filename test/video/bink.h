@@ -0,0 +1,135 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+#include "video/bink_dsp.h"
+#endif
+
+class BinkTestSuite : public CxxTest::TestSuite {
+#ifdef USE_BINK
+	static const int kBlocks = 20000;
+	static const int kPitch = 13;
+
+	// Xorshift generator with a fixed seed, so that all runs check the same blocks
+	static uint32 nextRandom(uint32 &seed) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+
+	// Coefficients as read by readDCTCoeffs(): a DC value, and AC values in
+	// a few of the columns only, so that the shortcut for columns without
+	// AC coefficients is taken as well
+	static void randomCoefficients(uint32 &seed, int32 *block) {
+		for (int i = 0; i < 64; i++)
+			block[i] = 0;
+
+		block[0] = (int32)(nextRandom(seed) % 4096) - 2048;
+
+		const uint32 columns = nextRandom(seed);
+		const int count = nextRandom(seed) % 24;
+		for (int i = 0; i < count; i++) {
+			const int index = 1 + nextRandom(seed) % 63;
+			if (columns & (1 << (index & 7)))
+				block[index] = (int32)(nextRandom(seed) % 4096) - 2048;
+		}
+	}
+
+	static void randomPixels(uint32 &seed, byte *pixels) {
+		for (int i = 0; i < 8 * kPitch; i++)
+			pixels[i] = (byte)nextRandom(seed);
+	}
+#endif
+
+public:
+	void test_idct_matches_scalar() {
+#ifdef USE_BINK
+		uint32 seed = 1;
+		int differences = 0;
+
+		for (int i = 0; i < kBlocks; i++) {
+			int32 expected[64], actual[64];
+			randomCoefficients(seed, expected);
+			memcpy(actual, expected, sizeof(actual));
+
+			Video::BinkDSP::idctScalar(expected);
+			Video::BinkDSP::idct(actual);
+
+			if (memcmp(expected, actual, sizeof(actual)))
+				differences++;
+		}
+
+		TS_ASSERT_EQUALS(differences, 0);
+#endif
+	}
+
+	void test_idct_put_and_add_match_scalar() {
+#ifdef USE_BINK
+		uint32 seed = 2;
+		int putDifferences = 0, addDifferences = 0;
+
+		for (int i = 0; i < kBlocks; i++) {
+			int32 coefficients[64], block[64];
+			randomCoefficients(seed, coefficients);
+
+			byte expected[8 * kPitch], actual[8 * kPitch];
+			randomPixels(seed, expected);
+			memcpy(actual, expected, sizeof(actual));
+
+			memcpy(block, coefficients, sizeof(block));
+			Video::BinkDSP::idctPutScalar(expected, kPitch, block);
+			memcpy(block, coefficients, sizeof(block));
+			Video::BinkDSP::idctPut(actual, kPitch, block);
+
+			// The bytes between the rows are compared as well, as they must
+			// be left alone
+			if (memcmp(expected, actual, sizeof(actual)))
+				putDifferences++;
+
+			memcpy(block, coefficients, sizeof(block));
+			Video::BinkDSP::idctAddScalar(expected, kPitch, block);
+			memcpy(block, coefficients, sizeof(block));
+			Video::BinkDSP::idctAdd(actual, kPitch, block);
+
+			if (memcmp(expected, actual, sizeof(actual)))
+				addDifferences++;
+		}
+
+		TS_ASSERT_EQUALS(putDifferences, 0);
+		TS_ASSERT_EQUALS(addDifferences, 0);
+#endif
+	}
+
+	void test_residue_matches_scalar() {
+#ifdef USE_BINK
+		uint32 seed = 3;
+		int differences = 0;
+
+		for (int i = 0; i < kBlocks; i++) {
+			// Residue values are small, but the additions wrap around all
+			// the same
+			int16 block[64];
+			for (int j = 0; j < 64; j++)
+				block[j] = (int16)(nextRandom(seed) % 512) - 256;
+
+			byte expected[8 * kPitch], actual[8 * kPitch];
+			randomPixels(seed, expected);
+			memcpy(actual, expected, sizeof(actual));
+
+			Video::BinkDSP::addResidueScalar(expected, kPitch, block);
+			Video::BinkDSP::addResidue(actual, kPitch, block);
+
+			if (memcmp(expected, actual, sizeof(actual)))
+				differences++;
+		}
+
+		TS_ASSERT_EQUALS(differences, 0);
+#endif
+	}
+};
@@ -0,0 +1,303 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/rational.h"
+#include "common/system.h"
+
+#include "graphics/pixelformat.h"
+#include "graphics/surface.h"
+
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	/**
+	 * A paletted video track whose pixels all use the same color, which is only
+	 * changed every other frame. Like the Flic, Smacker and DXA tracks, the track
+	 * reports a palette change only until the palette is read.
+	 */
+	class PaletteTestTrack : public FixedRateVideoTrack {
+	public:
+		PaletteTestTrack(int frameCount) : _curFrame(-1), _frameCount(frameCount), _dirtyPalette(false) {
+			_surface.create(6, 4, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_surface.getPixels(), kColor, _surface.pitch * _surface.h);
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~PaletteTestTrack() {
+			_surface.free();
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			if (_curFrame % 2 == 0) {
+				_palette[kColor * 3 + 0] = (byte)(_curFrame * 40);
+				_palette[kColor * 3 + 1] = (byte)(255 - _curFrame * 20);
+				_palette[kColor * 3 + 2] = (byte)(_curFrame * 10);
+				_dirtyPalette = true;
+			}
+			return &_surface;
+		}
+
+		const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+		// The color of the pixels of a frame
+		static uint32 getFrameColor(int frame, const Graphics::PixelFormat &format) {
+			frame -= frame % 2;
+			return format.RGBToColor(frame * 40, 255 - frame * 20, frame * 10);
+		}
+
+		static const byte kColor = 7;
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		int _frameCount;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+
+	/**
+	 * A seekable video track whose pixels all hold the number of the frame.
+	 * When reversed, each frame decoded is the one before the last.
+	 */
+	class NumberedTestTrack : public FixedRateVideoTrack {
+	public:
+		NumberedTestTrack(int frameCount) : _curFrame(-1), _frameCount(frameCount), _reversed(false) {
+			_surface.create(4, 2, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~NumberedTestTrack() {
+			_surface.free();
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+
+		bool endOfTrack() const override {
+			return _reversed ? _curFrame <= 0 : FixedRateVideoTrack::endOfTrack();
+		}
+
+		bool isSeekable() const override { return true; }
+
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		bool setReverse(bool reverse) override {
+			_reversed = reverse;
+			return true;
+		}
+
+		bool isReversed() const override { return _reversed; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame += _reversed ? -1 : 1;
+			memset(_surface.getPixels(), _curFrame, _surface.pitch * _surface.h);
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		int _frameCount;
+		bool _reversed;
+	};
+
+	bool loadStream(Common::SeekableReadStream *stream) override { return false; }
+
+	void addTestTrack(Track *track) { addTrack(track); }
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	// Returns the number of the frame, or -1 if there is none
+	static int getFrameNumber(const Graphics::Surface *frame) {
+		return frame ? *(const byte *)frame->getPixels() : -1;
+	}
+
+	static void installSystem() {
+		// The decoder reads the screen format
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	static bool isFilledWith(const Graphics::Surface &surface, uint32 color) {
+		for (int y = 0; y < surface.h; y++) {
+			for (int x = 0; x < surface.w; x++) {
+				if (surface.getPixel(x, y) != color)
+					return false;
+			}
+		}
+		return true;
+	}
+
+public:
+	void test_decode_into_converts_with_new_palette() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		static const int kFrames = 5;
+
+		installSystem();
+
+		TestVideoDecoder decoder;
+		decoder.addTestTrack(new TestVideoDecoder::PaletteTestTrack(kFrames));
+
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Graphics::Surface dst;
+		dst.create(6, 4, format);
+
+		for (int frame = 0; frame < kFrames; frame++) {
+			TS_ASSERT(decoder.decodeNextFrameInto(dst));
+			TS_ASSERT(isFilledWith(dst, TestVideoDecoder::PaletteTestTrack::getFrameColor(frame, format)));
+
+			// The caller still sees the palette change
+			TS_ASSERT_EQUALS(decoder.hasDirtyPalette(), frame % 2 == 0);
+			const byte *palette = decoder.getPalette();
+			TS_ASSERT(palette);
+			if (palette) {
+				const byte *color = palette + TestVideoDecoder::PaletteTestTrack::kColor * 3;
+				TS_ASSERT_EQUALS(format.RGBToColor(color[0], color[1], color[2]), TestVideoDecoder::PaletteTestTrack::getFrameColor(frame, format));
+			}
+		}
+
+		dst.free();
+		decoder.close();
+#endif
+	}
+
+	void test_decode_ahead_returns_frames_in_order() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		static const int kFrames = 8;
+		static const int kAhead = 3;
+
+		installSystem();
+
+		TestVideoDecoder decoder;
+		TestVideoDecoder::NumberedTestTrack *track = new TestVideoDecoder::NumberedTestTrack(kFrames);
+		decoder.addTestTrack(track);
+		decoder.setDecodeAheadFrames(kAhead);
+
+		const Graphics::Surface *surfaces[kFrames];
+		for (int frame = 0; frame < kFrames; frame++) {
+			decoder.decodeAhead();
+			TS_ASSERT_EQUALS(track->getCurFrame(), MIN(frame + kAhead - 1, kFrames - 1));
+
+			// The decoder still reports the frame returned last
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), frame - 1);
+
+			surfaces[frame] = decoder.decodeNextFrame();
+			TS_ASSERT_EQUALS(getFrameNumber(surfaces[frame]), frame);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), frame);
+		}
+
+		TS_ASSERT(decoder.endOfVideo());
+
+		// The surfaces of the frames returned are reused, so only one more
+		// than the frames decoded ahead is needed
+		for (int frame = kAhead + 1; frame < kFrames; frame++)
+			TS_ASSERT_EQUALS(surfaces[frame], surfaces[frame - kAhead - 1]);
+
+		decoder.close();
+#endif
+	}
+
+	void test_seek_discards_frames_decoded_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		installSystem();
+
+		TestVideoDecoder decoder;
+		decoder.addTestTrack(new TestVideoDecoder::NumberedTestTrack(10));
+		decoder.setDecodeAheadFrames(3);
+
+		TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 0);
+		decoder.decodeAhead();
+
+		TS_ASSERT(decoder.seekToFrame(6));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 5);
+		TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 6);
+
+		decoder.decodeAhead();
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 0);
+
+		decoder.close();
+#endif
+	}
+
+	void test_reverse_after_decode_ahead() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		installSystem();
+
+		// Reversing continues from the frame returned last, whether or not
+		// the frames after it were decoded ahead
+		for (int ahead = 0; ahead <= 3; ahead += 3) {
+			TestVideoDecoder decoder;
+			decoder.addTestTrack(new TestVideoDecoder::NumberedTestTrack(10));
+			decoder.setDecodeAheadFrames(ahead);
+
+			for (int frame = 0; frame < 3; frame++) {
+				decoder.decodeAhead();
+				TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), frame);
+			}
+
+			decoder.decodeAhead();
+			TS_ASSERT(decoder.setReverse(true));
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), 2);
+
+			// Reversed tracks are not decoded ahead
+			decoder.decodeAhead();
+			TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 1);
+			TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 0);
+			TS_ASSERT(decoder.endOfVideo());
+
+			decoder.close();
+		}
+#endif
+	}
+
+	void test_decode_ahead_stops_at_end_time() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		installSystem();
+
+		TestVideoDecoder decoder;
+		TestVideoDecoder::NumberedTestTrack *track = new TestVideoDecoder::NumberedTestTrack(10);
+		decoder.addTestTrack(track);
+		decoder.setDecodeAheadFrames(8);
+		decoder.start();
+
+		// Frames are not decoded past the end time
+		decoder.setEndTime(Audio::Timestamp(0, 6, 10));
+		TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), 0);
+		decoder.decodeAhead();
+		TS_ASSERT_EQUALS(track->getCurFrame(), 5);
+
+		// Frames decoded before an earlier end time was set are not returned
+		decoder.setEndTime(Audio::Timestamp(0, 3, 10));
+		for (int frame = 1; frame < 3; frame++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT_EQUALS(getFrameNumber(decoder.decodeNextFrame()), frame);
+		}
+		TS_ASSERT(decoder.endOfVideo());
+
+		decoder.close();
+#endif
+	}
+};
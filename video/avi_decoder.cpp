@@ -169,6 +169,15 @@ const Graphics::Surface *AVIDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool AVIDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	// Reverse playback seeks around each frame in decodeNextFrame()
+	for (uint idx = 0; idx < _videoTracks.size(); idx++)
+		if (static_cast<AVIVideoTrack *>(_videoTracks[idx].track)->isReversed())
+			return copyNextFrameInto(dst);
+
+	return VideoDecoder::decodeNextFrameInto(dst);
+}
+
 const Graphics::Surface *AVIDecoder::decodeNextTransparency() {
 	if (!_transparencyTrack.track)
 		return nullptr;
@@ -508,6 +517,7 @@ void AVIDecoder::close() {
 	_movieListEnd = 0;
 
 	_indexEntries.clear();
+	_chunkIndices.clear();
 	memset(&_header, 0, sizeof(_header));
 
 	_videoTracks.clear();
@@ -661,7 +671,7 @@ uint AVIDecoder::getVideoTrackOffset(uint trackIndex, uint frameNumber) {
 	if (trackIndex == _videoTracks.front().index && frameNumber == 0)
 		return _movieListStart;
 
-	OldIndex *entry = _indexEntries.find(trackIndex, frameNumber);
+	OldIndex *entry = findChunk(trackIndex, frameNumber);
 	assert(entry);
 	return entry->offset;
 }
@@ -695,57 +705,47 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 		frame = videoTrack->getFrameAtTime(time);
 	}
 
-	// Reset any palette, if necessary
-	videoTrack->useInitialPalette();
+	// Figure out where we should be
+	const ChunkIndex &videoChunks = getChunkIndex(videoIndex);
 
-	int lastKeyFrame = -1;
-	int frameIndex = -1;
-	uint curFrame = 0;
+	if (frame >= videoChunks.frames.size()) // This shouldn't happen.
+		return false;
 
-	// Go through and figure out where we should be
-	// If there's a palette, we need to find the palette too
-	for (uint32 i = 0; i < _indexEntries.size(); i++) {
-		const OldIndex &index = _indexEntries[i];
+	uint32 frameIndex = videoChunks.frames[frame];
 
-		// We don't care about RECs
-		if (index.id == ID_REC)
-			continue;
+	// Reset any palette, if necessary
+	videoTrack->useInitialPalette();
 
-		// We're only looking at entries for this track
-		if (getStreamIndex(index.id) != videoIndex)
-			continue;
+	// We need to handle any palette change before the frame since there's
+	// no flag to tell if this is a "key" palette.
+	for (uint32 i = 0; i < videoChunks.palettes.size() && videoChunks.palettes[i] < frameIndex; i++) {
+		// Decode the palette
+		const OldIndex &index = _indexEntries[videoChunks.palettes[i]];
+		_fileStream->seek(index.offset + 8);
+		Common::SeekableReadStream *chunk = 0;
 
-		uint16 streamType = getStreamType(index.id);
+		if (index.size != 0)
+			chunk = _fileStream->readStream(index.size);
 
-		if (streamType == kStreamTypePaletteChange) {
-			// We need to handle any palette change we see since there's no
-			// flag to tell if this is a "key" palette.
-			// Decode the palette
-			_fileStream->seek(_indexEntries[i].offset + 8);
-			Common::SeekableReadStream *chunk = 0;
+		videoTrack->loadPaletteFromChunk(chunk);
+	}
 
-			if (_indexEntries[i].size != 0)
-				chunk = _fileStream->readStream(_indexEntries[i].size);
+	// Find the last keyframe up to the frame with a binary search
+	// The first frame always counts as a keyframe
+	uint32 low = 0;
+	uint32 high = videoChunks.keyFrames.size();
 
-			videoTrack->loadPaletteFromChunk(chunk);
-		} else {
-			// Check to see if this is a keyframe
-			// The first frame has to be a keyframe
-			if ((_indexEntries[i].flags & AVIIF_INDEX) || curFrame == 0)
-				lastKeyFrame = i;
-
-			// Did we find the target frame?
-			if (frame == curFrame) {
-				frameIndex = i;
-				break;
-			}
+	while (low < high) {
+		uint32 mid = (low + high) / 2;
 
-			curFrame++;
-		}
+		if (videoChunks.keyFrames[mid] <= frame)
+			low = mid + 1;
+		else
+			high = mid;
 	}
 
-	if (frameIndex < 0) // This shouldn't happen.
-		return false;
+	assert(low > 0);
+	uint32 lastKeyFrame = videoChunks.keyFrames[low - 1];
 
 	// Update all the audio tracks
 	for (uint32 i = 0; i < _audioTracks.size(); i++) {
@@ -757,25 +757,15 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 		// Set the chunk index for the track
 		audioTrack->setCurChunk(frame);
 
-		uint32 chunksFound = 0;
-		for (uint32 j = 0; j < _indexEntries.size(); j++) {
+		const ChunkIndex &audioChunks = getChunkIndex(_audioTracks[i].index);
+		if (frame < audioChunks.chunks.size()) {
+			uint32 j = audioChunks.chunks[frame];
 			const OldIndex &index = _indexEntries[j];
 
-			// Continue ignoring RECs
-			if (index.id == ID_REC)
-				continue;
-
-			if (getStreamIndex(index.id) == _audioTracks[i].index) {
-				if (chunksFound == frame) {
-					_fileStream->seek(index.offset + 8);
-					Common::SeekableReadStream *audioChunk = _fileStream->readStream(index.size);
-					audioTrack->queueSound(audioChunk);
-					_audioTracks[i].chunkSearchOffset = (j == _indexEntries.size() - 1) ? _movieListEnd : _indexEntries[j + 1].offset;
-					break;
-				}
-
-				chunksFound++;
-			}
+			_fileStream->seek(index.offset + 8);
+			Common::SeekableReadStream *audioChunk = _fileStream->readStream(index.size);
+			audioTrack->queueSound(audioChunk);
+			_audioTracks[i].chunkSearchOffset = (j == _indexEntries.size() - 1) ? _movieListEnd : _indexEntries[j + 1].offset;
 		}
 
 		// Skip any audio to bring us to the right time
@@ -783,25 +773,13 @@ bool AVIDecoder::seekIntern(const Audio::Timestamp &time) {
 	}
 
 	// Decode from keyFrame to curFrame - 1
-	for (int i = lastKeyFrame; i < frameIndex; i++) {
-		if (_indexEntries[i].id == ID_REC)
-			continue;
-
-		if (getStreamIndex(_indexEntries[i].id) != videoIndex)
-			continue;
-
-		uint16 streamType = getStreamType(_indexEntries[i].id);
-
-		// Ignore palettes, they were already handled
-		if (streamType == kStreamTypePaletteChange)
-			continue;
-
-		// Frame, hopefully
-		_fileStream->seek(_indexEntries[i].offset + 8);
+	for (uint32 i = lastKeyFrame; i < frame; i++) {
+		const OldIndex &index = _indexEntries[videoChunks.frames[i]];
+		_fileStream->seek(index.offset + 8);
 		Common::SeekableReadStream *chunk = 0;
 
-		if (_indexEntries[i].size != 0)
-			chunk = _fileStream->readStream(_indexEntries[i].size);
+		if (index.size != 0)
+			chunk = _fileStream->readStream(index.size);
 
 		videoTrack->decodeFrame(chunk);
 	}
@@ -826,7 +804,7 @@ void AVIDecoder::seekTransparencyFrame(int frame) {
 	int indexFrame = frame;
 	OldIndex *entry = nullptr;
 	do {
-		entry = _indexEntries.find(status.index, indexFrame);
+		entry = findChunk(status.index, indexFrame);
 	} while (!entry && indexFrame-- > 0);
 	assert(entry);
 
@@ -1197,16 +1175,44 @@ void AVIDecoder::AVIAudioTrack::createAudioStream() {
 AVIDecoder::TrackStatus::TrackStatus() : track(0), chunkSearchOffset(0) {
 }
 
-AVIDecoder::OldIndex *AVIDecoder::IndexEntries::find(uint index, uint frameNumber) {
-	for (uint idx = 0, frameCtr = 0; idx < size(); ++idx) {
-		if ((*this)[idx].id != ID_REC &&
-				AVIDecoder::getStreamIndex((*this)[idx].id) == index) {
-			if (frameCtr++ == frameNumber)
-				return &(*this)[idx];
+const AVIDecoder::ChunkIndex &AVIDecoder::getChunkIndex(uint streamIndex) {
+	if (_chunkIndices.empty()) {
+		for (uint32 i = 0; i < _indexEntries.size(); i++) {
+			const OldIndex &index = _indexEntries[i];
+
+			// We don't care about RECs
+			if (index.id == ID_REC)
+				continue;
+
+			uint stream = getStreamIndex(index.id);
+			if (stream >= _chunkIndices.size())
+				_chunkIndices.resize(stream + 1);
+
+			ChunkIndex &chunkIndex = _chunkIndices[stream];
+			chunkIndex.chunks.push_back(i);
+
+			if (getStreamType(index.id) == kStreamTypePaletteChange) {
+				chunkIndex.palettes.push_back(i);
+			} else {
+				// The first frame has to be a keyframe
+				if ((index.flags & AVIIF_INDEX) || chunkIndex.frames.empty())
+					chunkIndex.keyFrames.push_back(chunkIndex.frames.size());
+
+				chunkIndex.frames.push_back(i);
+			}
 		}
 	}
 
-	return nullptr;
+	static const ChunkIndex emptyChunkIndex;
+	return streamIndex < _chunkIndices.size() ? _chunkIndices[streamIndex] : emptyChunkIndex;
+}
+
+AVIDecoder::OldIndex *AVIDecoder::findChunk(uint streamIndex, uint chunkNumber) {
+	const ChunkIndex &chunkIndex = getChunkIndex(streamIndex);
+	if (chunkNumber >= chunkIndex.chunks.size())
+		return nullptr;
+
+	return &_indexEntries[chunkIndex.chunks[chunkNumber]];
 }
 
 } // End of namespace Video
@@ -91,6 +91,7 @@ public:
 	 * @note this may return 0, in which case the last frame should be kept on screen
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
+	virtual bool decodeNextFrameInto(Graphics::Surface &dst);
 
 	/**
 	 * Decodes the next transparency track frame
@@ -312,15 +313,23 @@ protected:
 		uint32 chunkSearchOffset;
 	};
 
-	class IndexEntries : public Common::Array<OldIndex> {
-	public:
-		OldIndex *find(uint index, uint frameNumber);
-	};
-
 	AVIHeader _header;
 
 	void readOldIndex(uint32 size);
-	IndexEntries _indexEntries;
+	Common::Array<OldIndex> _indexEntries;
+
+	// The positions in _indexEntries of the chunks of a stream, so that
+	// seeking does not have to go through the whole index
+	struct ChunkIndex {
+		Common::Array<uint32> chunks;    // All chunks of the stream
+		Common::Array<uint32> frames;    // The chunks which are not palette changes
+		Common::Array<uint32> keyFrames; // The numbers of the frames which are key frames
+		Common::Array<uint32> palettes;  // The palette change chunks
+	};
+
+	Common::Array<ChunkIndex> _chunkIndices; // Built on first use
+	const ChunkIndex &getChunkIndex(uint streamIndex);
+	OldIndex *findChunk(uint streamIndex, uint chunkNumber);
 
 	Common::SeekableReadStream *_fileStream;
 	bool _decodedHeader;
@@ -44,6 +44,7 @@
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_dsp.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -284,6 +285,7 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	// surface.
 	_surface.h = height;
 	_surface.w = width;
+	_surfaceConverted = true;
 
 	// Compute the video dimensions in blocks
 	_yBlockWidth   = (width  +  7) >> 3;
@@ -443,6 +445,42 @@ bool BinkDecoder::BinkAudioTrack::seek(const Audio::Timestamp &time) {
 	return true;
 }
 
+const Graphics::Surface *BinkDecoder::BinkVideoTrack::decodeNextFrame() {
+	if (!_surfaceConverted) {
+		convertFrame(_surface);
+		_surfaceConverted = true;
+	}
+
+	return &_surface;
+}
+
+bool BinkDecoder::BinkVideoTrack::canDecodeNextFrameInto(const Graphics::Surface &dst) const {
+	// The YUV data can be converted to any high color format, but the
+	// conversion writes the even-sized surface
+	return dst.w >= _surfaceWidth && dst.h >= _surfaceHeight && (dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4);
+}
+
+bool BinkDecoder::BinkVideoTrack::decodeNextFrameInto(Graphics::Surface &dst, bool partial) {
+	convertFrame(dst);
+	return true;
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame(Graphics::Surface &dst) {
+	// Convert the YUV data we have to our format. The last decoded frame is
+	// in the reference planes.
+	// The width used here is the surface-width, and not the video-width
+	// to allow for odd-sized videos.
+	if (_hasAlpha) {
+		assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2] && _oldPlanes[3]);
+		YUVToRGBMan.convert420Alpha(&dst, Graphics::YUVToRGBManager::kScaleITU, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2], _oldPlanes[3],
+				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	} else {
+		assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2]);
+		YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2],
+				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	}
+}
+
 bool BinkDecoder::BinkVideoTrack::rewind() {
 	if (!VideoTrack::rewind()) {
 		return false;
@@ -485,23 +523,14 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
-	// Convert the YUV data we have to our format
-	// The width used here is the surface-width, and not the video-width
-	// to allow for odd-sized videos.
-	if (_hasAlpha) {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-		YUVToRGBMan.convert420Alpha(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	} else {
-		assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2]);
-		YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2],
-				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
-	}
-
-	// And swap the planes with the reference planes
+	// Swap the planes with the reference planes. The YUV data is converted
+	// when the frame is requested, and straight to the caller's surface
+	// for decodeNextFrameInto().
 	for (int i = 0; i < 4; i++)
 		SWAP(_curPlanes[i], _oldPlanes[i]);
 
+	_surfaceConverted = false;
+
 	_curFrame++;
 }
 
@@ -822,7 +851,7 @@ void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
+	BinkDSP::idct(block);
 
 	int32 *src   = block;
 	byte  *dest1 = ctx.dest;
@@ -952,11 +981,7 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	BinkDSP::addResidue(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -967,7 +992,7 @@ void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	BinkDSP::idctPut(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -988,7 +1013,7 @@ void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	BinkDSP::idctAdd(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1416,88 +1441,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-	const int a0 = (src)[s0] + (src)[s4]; \
-	const int a1 = (src)[s0] - (src)[s4]; \
-	const int a2 = (src)[s2] + (src)[s6]; \
-	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-	const int a4 = (src)[s5] + (src)[s3]; \
-	const int a5 = (src)[s5] - (src)[s3]; \
-	const int a6 = (src)[s1] + (src)[s7]; \
-	const int a7 = (src)[s1] - (src)[s7]; \
-	const int b0 = a4 + a6; \
-	const int b1 = (A3*(a5 + a7)) >> 11; \
-	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-	(dest)[d0] = munge(a0+a2   +b0); \
-	(dest)[d1] = munge(a1+a3-a2+b2); \
-	(dest)[d2] = munge(a1-a3+a2+b3); \
-	(dest)[d3] = munge(a0-a2   -b4); \
-	(dest)[d4] = munge(a0-a2   +b4); \
-	(dest)[d5] = munge(a1-a3+a2-b3); \
-	(dest)[d6] = munge(a1+a3-a2-b2); \
-	(dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
@@ -153,7 +153,9 @@ private:
 		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
 		int getCurFrame() const override { return _curFrame; }
 		int getFrameCount() const override { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() override { return &_surface; }
+		const Graphics::Surface *decodeNextFrame() override;
+		bool canDecodeNextFrameInto(const Graphics::Surface &dst) const override;
+		bool decodeNextFrameInto(Graphics::Surface &dst, bool partial) override;
 		bool isSeekable() const  override{ return true; }
 		bool seek(const Audio::Timestamp &time) override { return true; }
 		bool rewind() override;
@@ -162,6 +164,9 @@ private:
 		/** Decode a video packet. */
 		void decodePacket(VideoFrame &frame);
 
+		/** Convert the last decoded frame to RGB. */
+		void convertFrame(Graphics::Surface &dst);
+
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
 	private:
@@ -244,6 +249,7 @@ private:
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		bool _surfaceConverted; ///< Does the surface contain the last decoded frame?
 
 		uint32 _id; ///< The BIK FourCC.
 
@@ -323,11 +329,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle, int startBits, bool hasSign);
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
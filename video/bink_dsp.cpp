@@ -0,0 +1,340 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Based on eos' Bink decoder which is in turn
+// based quite heavily on the Bink decoder found in FFmpeg.
+// Many thanks to Kostya Shishkov for doing the hard work.
+
+#include "common/scummsys.h"
+
+#include "video/bink_dsp.h"
+
+// The IDCT and the residue of blocks are computed on whole rows where an
+// instruction set is available
+#include "common/simd.h"
+
+namespace Video {
+
+namespace BinkDSP {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+	const int a0 = (src)[s0] + (src)[s4]; \
+	const int a1 = (src)[s0] - (src)[s4]; \
+	const int a2 = (src)[s2] + (src)[s6]; \
+	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+	const int a4 = (src)[s5] + (src)[s3]; \
+	const int a5 = (src)[s5] - (src)[s3]; \
+	const int a6 = (src)[s1] + (src)[s7]; \
+	const int a7 = (src)[s1] - (src)[s7]; \
+	const int b0 = a4 + a6; \
+	const int b1 = (A3*(a5 + a7)) >> 11; \
+	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+	(dest)[d0] = munge(a0+a2   +b0); \
+	(dest)[d1] = munge(a1+a3-a2+b2); \
+	(dest)[d2] = munge(a1-a3+a2+b3); \
+	(dest)[d3] = munge(a0-a2   -b4); \
+	(dest)[d4] = munge(a0-a2   +b4); \
+	(dest)[d5] = munge(a1-a3+a2-b3); \
+	(dest)[d6] = munge(a1+a3-a2-b2); \
+	(dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void IDCTCol(int32 *dest, const int32 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+void idctScalar(int32 *block) {
+	int i;
+	int32 temp[64];
+
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+void idctAddScalar(byte *dest, int pitch, int32 *block) {
+	int i, j;
+
+	idctScalar(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+void idctPutScalar(byte *dest, int pitch, int32 *block) {
+	int i;
+	int32 temp[64];
+	for (i = 0; i < 8; i++)
+		IDCTCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+void addResidueScalar(byte *dest, int pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+#ifdef SCUMMVM_SIMD
+
+// The vectorized IDCT computes four columns, then four rows, at a time with
+// the same integer operations as IDCT_TRANSFORM, so that it gives the same
+// results. The shortcut of IDCTCol() for columns without AC coefficients
+// does not change the results either.
+
+#if defined(SCUMMVM_SIMD_SSE2)
+
+typedef __m128i IDCTVector;
+
+static inline IDCTVector vecLoad(const int32 *src) { return _mm_loadu_si128((const __m128i *)src); }
+static inline void vecStore(int32 *dest, IDCTVector v) { _mm_storeu_si128((__m128i *)dest, v); }
+static inline IDCTVector vecAdd(IDCTVector a, IDCTVector b) { return _mm_add_epi32(a, b); }
+static inline IDCTVector vecSub(IDCTVector a, IDCTVector b) { return _mm_sub_epi32(a, b); }
+
+// (a * k) >> 11, with SSE2 lacking a 32-bit multiplication keeping the low bits
+static inline IDCTVector vecMulShift(IDCTVector a, int k) {
+	const __m128i factor = _mm_set1_epi32(k);
+	__m128i even = _mm_mul_epu32(a, factor);
+	__m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+	__m128i product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	return _mm_srai_epi32(product, 11);
+}
+
+static inline IDCTVector vecMungeRow(IDCTVector a) { return _mm_srai_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x7F)), 8); }
+
+static inline void vecTranspose(IDCTVector &a, IDCTVector &b, IDCTVector &c, IDCTVector &d) {
+	__m128i ab0 = _mm_unpacklo_epi32(a, b);
+	__m128i ab1 = _mm_unpackhi_epi32(a, b);
+	__m128i cd0 = _mm_unpacklo_epi32(c, d);
+	__m128i cd1 = _mm_unpackhi_epi32(c, d);
+	a = _mm_unpacklo_epi64(ab0, cd0);
+	b = _mm_unpackhi_epi64(ab0, cd0);
+	c = _mm_unpacklo_epi64(ab1, cd1);
+	d = _mm_unpackhi_epi64(ab1, cd1);
+}
+
+// The low byte of each of the eight values of a row
+static inline __m128i vecRowBytes(IDCTVector left, IDCTVector right) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	__m128i words = _mm_packs_epi32(_mm_and_si128(left, mask), _mm_and_si128(right, mask));
+	return _mm_packus_epi16(words, words);
+}
+
+static inline void vecPutRow(byte *dest, IDCTVector left, IDCTVector right) {
+	_mm_storel_epi64((__m128i *)dest, vecRowBytes(left, right));
+}
+
+static inline void vecAddRow(byte *dest, IDCTVector left, IDCTVector right) {
+	__m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+	_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, vecRowBytes(left, right)));
+}
+
+#else
+
+typedef int32x4_t IDCTVector;
+
+static inline IDCTVector vecLoad(const int32 *src) { return vld1q_s32(src); }
+static inline void vecStore(int32 *dest, IDCTVector v) { vst1q_s32(dest, v); }
+static inline IDCTVector vecAdd(IDCTVector a, IDCTVector b) { return vaddq_s32(a, b); }
+static inline IDCTVector vecSub(IDCTVector a, IDCTVector b) { return vsubq_s32(a, b); }
+static inline IDCTVector vecMulShift(IDCTVector a, int k) { return vshrq_n_s32(vmulq_n_s32(a, k), 11); }
+static inline IDCTVector vecMungeRow(IDCTVector a) { return vshrq_n_s32(vaddq_s32(a, vdupq_n_s32(0x7F)), 8); }
+
+static inline void vecTranspose(IDCTVector &a, IDCTVector &b, IDCTVector &c, IDCTVector &d) {
+	int32x4x2_t ab = vtrnq_s32(a, b);
+	int32x4x2_t cd = vtrnq_s32(c, d);
+	a = vcombine_s32(vget_low_s32(ab.val[0]), vget_low_s32(cd.val[0]));
+	b = vcombine_s32(vget_low_s32(ab.val[1]), vget_low_s32(cd.val[1]));
+	c = vcombine_s32(vget_high_s32(ab.val[0]), vget_high_s32(cd.val[0]));
+	d = vcombine_s32(vget_high_s32(ab.val[1]), vget_high_s32(cd.val[1]));
+}
+
+// The low byte of each of the eight values of a row
+static inline uint8x8_t vecRowBytes(IDCTVector left, IDCTVector right) {
+	int16x8_t words = vcombine_s16(vmovn_s32(left), vmovn_s32(right));
+	return vreinterpret_u8_s8(vmovn_s16(words));
+}
+
+static inline void vecPutRow(byte *dest, IDCTVector left, IDCTVector right) {
+	vst1_u8(dest, vecRowBytes(left, right));
+}
+
+static inline void vecAddRow(byte *dest, IDCTVector left, IDCTVector right) {
+	vst1_u8(dest, vadd_u8(vld1_u8(dest), vecRowBytes(left, right)));
+}
+
+#endif
+
+static inline void idctTransform(IDCTVector *d, const IDCTVector *s) {
+	const IDCTVector a0 = vecAdd(s[0], s[4]);
+	const IDCTVector a1 = vecSub(s[0], s[4]);
+	const IDCTVector a2 = vecAdd(s[2], s[6]);
+	const IDCTVector a3 = vecMulShift(vecSub(s[2], s[6]), A1);
+	const IDCTVector a4 = vecAdd(s[5], s[3]);
+	const IDCTVector a5 = vecSub(s[5], s[3]);
+	const IDCTVector a6 = vecAdd(s[1], s[7]);
+	const IDCTVector a7 = vecSub(s[1], s[7]);
+	const IDCTVector b0 = vecAdd(a4, a6);
+	const IDCTVector b1 = vecMulShift(vecAdd(a5, a7), A3);
+	const IDCTVector b2 = vecAdd(vecSub(vecMulShift(a5, A4), b0), b1);
+	const IDCTVector b3 = vecSub(vecMulShift(vecSub(a6, a4), A1), b2);
+	const IDCTVector b4 = vecSub(vecAdd(vecMulShift(a7, A2), b3), b1);
+	d[0] = vecAdd(vecAdd(a0, a2), b0);
+	d[1] = vecAdd(vecSub(vecAdd(a1, a3), a2), b2);
+	d[2] = vecAdd(vecAdd(vecSub(a1, a3), a2), b3);
+	d[3] = vecSub(vecSub(a0, a2), b4);
+	d[4] = vecAdd(vecSub(a0, a2), b4);
+	d[5] = vecSub(vecAdd(vecSub(a1, a3), a2), b3);
+	d[6] = vecSub(vecSub(vecAdd(a1, a3), a2), b2);
+	d[7] = vecSub(vecAdd(a0, a2), b0);
+}
+
+// Transforms the block, leaving the left and right halves of each row in
+// rows[i] and rows[i + 8].
+static void idctRows(const int32 *block, IDCTVector *rows) {
+	IDCTVector src[8], dest[8];
+
+	// Columns, four at a time
+	for (int half = 0; half < 2; half++) {
+		for (int i = 0; i < 8; i++)
+			src[i] = vecLoad(block + i * 8 + half * 4);
+
+		idctTransform(rows + half * 8, src);
+	}
+
+	// Rows, four at a time, transposing them to columns and back
+	for (int quarter = 0; quarter < 8; quarter += 4) {
+		for (int half = 0; half < 2; half++) {
+			IDCTVector *part = src + half * 4;
+			for (int i = 0; i < 4; i++)
+				part[i] = rows[half * 8 + quarter + i];
+
+			vecTranspose(part[0], part[1], part[2], part[3]);
+		}
+
+		idctTransform(dest, src);
+
+		for (int i = 0; i < 8; i++)
+			dest[i] = vecMungeRow(dest[i]);
+
+		vecTranspose(dest[0], dest[1], dest[2], dest[3]);
+		vecTranspose(dest[4], dest[5], dest[6], dest[7]);
+
+		for (int i = 0; i < 4; i++) {
+			rows[quarter + i]     = dest[i];
+			rows[quarter + i + 8] = dest[i + 4];
+		}
+	}
+}
+
+void idct(int32 *block) {
+	IDCTVector rows[16];
+	idctRows(block, rows);
+
+	for (int i = 0; i < 8; i++) {
+		vecStore(block + i * 8,     rows[i]);
+		vecStore(block + i * 8 + 4, rows[i + 8]);
+	}
+}
+
+void idctAdd(byte *dest, int pitch, int32 *block) {
+	IDCTVector rows[16];
+	idctRows(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vecAddRow(dest, rows[i], rows[i + 8]);
+}
+
+void idctPut(byte *dest, int pitch, int32 *block) {
+	IDCTVector rows[16];
+	idctRows(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vecPutRow(dest, rows[i], rows[i + 8]);
+}
+
+void addResidue(byte *dest, int pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8) {
+		// The residue wraps around, like the scalar byte additions
+#if defined(SCUMMVM_SIMD_SSE2)
+		__m128i residue = _mm_and_si128(_mm_loadu_si128((const __m128i *)block), _mm_set1_epi16(0xFF));
+		__m128i pixels = _mm_loadl_epi64((const __m128i *)dest);
+		_mm_storel_epi64((__m128i *)dest, _mm_add_epi8(pixels, _mm_packus_epi16(residue, residue)));
+#else
+		uint8x8_t residue = vreinterpret_u8_s8(vmovn_s16(vld1q_s16(block)));
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), residue));
+#endif
+	}
+}
+
+#else
+
+void idct(int32 *block) {
+	idctScalar(block);
+}
+
+void idctAdd(byte *dest, int pitch, int32 *block) {
+	idctAddScalar(dest, pitch, block);
+}
+
+void idctPut(byte *dest, int pitch, int32 *block) {
+	idctPutScalar(dest, pitch, block);
+}
+
+void addResidue(byte *dest, int pitch, const int16 *block) {
+	addResidueScalar(dest, pitch, block);
+}
+
+#endif
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The transforms of the Bink video blocks. They are vectorized where an
+ * instruction set is available, see common/simd.h. The scalar versions are
+ * always built, so that the vectorized ones can be checked against them.
+ *
+ * Blocks are 8x8 values in rows, and the pixels they are written or added
+ * to are 8 rows of 8 bytes, pitch bytes apart. Additions wrap around.
+ */
+namespace BinkDSP {
+
+/** Apply the inverse DCT to a block of coefficients, in place. */
+void idct(int32 *block);
+
+/** Write the inverse DCT of a block of coefficients to the pixels. */
+void idctPut(byte *dest, int pitch, int32 *block);
+
+/** Add the inverse DCT of a block of coefficients to the pixels. */
+void idctAdd(byte *dest, int pitch, int32 *block);
+
+/** Add the low bytes of a block of residue values to the pixels. */
+void addResidue(byte *dest, int pitch, const int16 *block);
+
+void idctScalar(int32 *block);
+void idctPutScalar(byte *dest, int pitch, int32 *block);
+void idctAddScalar(byte *dest, int pitch, int32 *block);
+void addResidueScalar(byte *dest, int pitch, const int16 *block);
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
+
+#endif
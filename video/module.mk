@@ -17,7 +17,8 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bink_decoder.o
+	bink_decoder.o \
+	bink_dsp.o
 endif
 
 ifdef USE_THEORADEC
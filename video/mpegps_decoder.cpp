@@ -586,6 +586,7 @@ void MPEGPSDecoder::MPEGPSDemuxer::parseProgramStreamMap(int length) {
 
 MPEGPSDecoder::MPEGVideoTrack::MPEGVideoTrack(Common::SeekableReadStream *firstPacket, const Graphics::PixelFormat &format) {
 	_surface = 0;
+	_surfaceConverted = true;
 	_endOfTrack = false;
 	_curFrame = -1;
 	_framePts = 0xFFFFFFFF;
@@ -625,9 +626,35 @@ Graphics::PixelFormat MPEGPSDecoder::MPEGVideoTrack::getPixelFormat() const {
 }
 
 const Graphics::Surface *MPEGPSDecoder::MPEGVideoTrack::decodeNextFrame() {
+#ifdef USE_MPEG2
+	// Frames are only converted once it is known where they are needed
+	if (!_surfaceConverted) {
+		_mpegDecoder->convertFrame(*_surface);
+		_surfaceConverted = true;
+	}
+#endif
+
 	return _surface;
 }
 
+bool MPEGPSDecoder::MPEGVideoTrack::canDecodeNextFrameInto(const Graphics::Surface &dst) const {
+#ifdef USE_MPEG2
+	// Convert straight to the surface of the caller when it can take the
+	// whole frame in a format the YUV conversion can write
+	return (dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4) && dst.w >= _surface->w && dst.h >= _surface->h;
+#else
+	return false;
+#endif
+}
+
+bool MPEGPSDecoder::MPEGVideoTrack::decodeNextFrameInto(Graphics::Surface &dst, bool partial) {
+#ifdef USE_MPEG2
+	return _mpegDecoder->convertFrame(dst);
+#else
+	return false;
+#endif
+}
+
 bool MPEGPSDecoder::MPEGVideoTrack::sendPacket(Common::SeekableReadStream *packet, uint32 pts, uint32 dts) {
 #ifdef USE_MPEG2
 	if (pts != 0xFFFFFFFF) {
@@ -635,10 +662,11 @@ bool MPEGPSDecoder::MPEGVideoTrack::sendPacket(Common::SeekableReadStream *packe
 	}
 
 	uint32 framePeriod;
-	bool foundFrame = _mpegDecoder->decodePacket(*packet, framePeriod, _surface);
+	bool foundFrame = _mpegDecoder->decodePacketPlanes(*packet, framePeriod);
 
 	if (foundFrame) {
 		_curFrame++;
+		_surfaceConverted = false;
 
 		// If there has been a timestamp since the previous frame, use that for
 		// syncing. Usually it will be the timestamp from the current packet,
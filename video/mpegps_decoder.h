@@ -123,6 +123,8 @@ private:
 		int getCurFrame() const { return _curFrame; }
 		uint32 getNextFrameStartTime() const { return _nextFrameStartTime.msecs(); }
 		const Graphics::Surface *decodeNextFrame();
+		bool canDecodeNextFrameInto(const Graphics::Surface &dst) const;
+		bool decodeNextFrameInto(Graphics::Surface &dst, bool partial);
 
 		bool sendPacket(Common::SeekableReadStream *packet, uint32 pts, uint32 dts);
 		StreamType getStreamType() const { return kStreamTypeVideo; }
@@ -135,6 +137,7 @@ private:
 		uint32 _framePts;
 		Audio::Timestamp _nextFrameStartTime;
 		Graphics::Surface *_surface;
+		bool _surfaceConverted;
 
 		void findDimensions(Common::SeekableReadStream *firstPacket, const Graphics::PixelFormat &format);
 
@@ -105,6 +105,19 @@ const Graphics::Surface *QuickTimeDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool QuickTimeDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	// Scaled frames go through the scaled surface
+	if (_scaleFactorX != 1 || _scaleFactorY != 1)
+		return copyNextFrameInto(dst);
+
+	bool decoded = VideoDecoder::decodeNextFrameInto(dst);
+
+	// Update audio buffers too
+	updateAudioBuffer();
+
+	return decoded;
+}
+
 Common::QuickTimeParser::SampleDesc *QuickTimeDecoder::readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize) {
 	if (track->codecType == CODEC_TYPE_VIDEO) {
 		debug(0, "Video Codec FourCC: \'%s\'", tag2str(format));
@@ -632,41 +645,53 @@ Common::Rational QuickTimeDecoder::VideoTrackHandler::getScaledHeight() const {
 	return Common::Rational(_parent->height) / _parent->scaleFactorY;
 }
 
-Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
-	// First, we have to track down which chunk holds the sample and which sample in the chunk contains the frame we are looking for.
-	int32 totalSampleCount = 0;
-	int32 sampleInChunk = 0;
-	int32 actualChunk = -1;
+void QuickTimeDecoder::VideoTrackHandler::buildFrameLocations() {
+	// Go through the chunks, and the samples in each of them, until the
+	// location of every frame is known
+	const uint32 frameCount = MAX(_parent->frameCount, _parent->sampleCount);
 	uint32 sampleToChunkIndex = 0;
 
-	for (uint32 i = 0; i < _parent->chunkCount; i++) {
+	_frameLocations.reserve(frameCount);
+
+	for (uint32 i = 0; i < _parent->chunkCount && _frameLocations.size() < frameCount; i++) {
 		if (sampleToChunkIndex < _parent->sampleToChunkCount && i >= _parent->sampleToChunk[sampleToChunkIndex].first)
 			sampleToChunkIndex++;
 
-		totalSampleCount += _parent->sampleToChunk[sampleToChunkIndex - 1].count;
+		if (sampleToChunkIndex == 0)
+			continue;
 
-		if (totalSampleCount > _curFrame) {
-			actualChunk = i;
-			descId = _parent->sampleToChunk[sampleToChunkIndex - 1].id;
-			sampleInChunk = _parent->sampleToChunk[sampleToChunkIndex - 1].count - totalSampleCount + _curFrame;
-			break;
+		const Common::QuickTimeParser::SampleToChunkEntry &entry = _parent->sampleToChunk[sampleToChunkIndex - 1];
+		uint32 offset = _parent->chunkOffsets[i];
+
+		for (uint32 j = 0; j < entry.count && _frameLocations.size() < frameCount; j++) {
+			FrameLocation location;
+			location.offset = offset;
+			location.descId = entry.id;
+			_frameLocations.push_back(location);
+
+			if (_parent->sampleSize != 0)
+				offset += _parent->sampleSize;
+			else if (_frameLocations.size() <= _parent->sampleCount)
+				offset += _parent->sampleSizes[_frameLocations.size() - 1];
 		}
 	}
+}
+
+Common::SeekableReadStream *QuickTimeDecoder::VideoTrackHandler::getNextFramePacket(uint32 &descId) {
+	// First, we have to track down where the frame we are looking for is, and
+	// which sample description it uses.
+	if (_frameLocations.empty())
+		buildFrameLocations();
 
-	if (actualChunk < 0)
+	if (_curFrame < 0 || (uint32)_curFrame >= _frameLocations.size())
 		error("Could not find data for frame %d", _curFrame);
 
+	const FrameLocation &location = _frameLocations[_curFrame];
+	descId = location.descId;
+
 	// Next seek to that frame
 	Common::SeekableReadStream *stream = _decoder->_fd;
-	stream->seek(_parent->chunkOffsets[actualChunk]);
-
-	// Then, if the chunk holds more than one frame, seek to where the frame we want is located
-	for (int32 i = _curFrame - sampleInChunk; i < _curFrame; i++) {
-		if (_parent->sampleSize != 0)
-			stream->skip(_parent->sampleSize);
-		else
-			stream->skip(_parent->sampleSizes[i]);
-	}
+	stream->seek(location.offset);
 
 	// Finally, read in the raw data for the frame
 	//debug("Frame Data[%d]: Offset = %d, Size = %d", _curFrame, stream->pos(), _parent->sampleSizes[_curFrame]);
@@ -693,9 +718,21 @@ uint32 QuickTimeDecoder::VideoTrackHandler::getCurFrameDuration() {
 }
 
 uint32 QuickTimeDecoder::VideoTrackHandler::findKeyFrame(uint32 frame) const {
-	for (int i = _parent->keyframeCount - 1; i >= 0; i--)
-		if (_parent->keyframes[i] <= frame)
-			return _parent->keyframes[i];
+	// The key frames are sorted, look for the first one after the frame
+	uint32 low = 0;
+	uint32 high = _parent->keyframeCount;
+
+	while (low < high) {
+		uint32 mid = (low + high) / 2;
+
+		if (_parent->keyframes[mid] <= frame)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low > 0)
+		return _parent->keyframes[low - 1];
 
 	// If none found, we'll assume the requested frame is a key frame
 	return frame;
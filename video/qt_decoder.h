@@ -68,6 +68,7 @@ public:
 	uint16 getWidth() const { return _width; }
 	uint16 getHeight() const { return _height; }
 	const Graphics::Surface *decodeNextFrame();
+	bool decodeNextFrameInto(Graphics::Surface &dst);
 	Audio::Timestamp getDuration() const { return Audio::Timestamp(0, _duration, _timeScale); }
 
 	void enableEditListBoundsCheckQuirk(bool enable) { _enableEditListBoundsCheckQuirk = enable; }
@@ -167,6 +168,14 @@ private:
 		Graphics::Surface *_ditherFrame;
 		const Graphics::Surface *forceDither(const Graphics::Surface &frame);
 
+		// Where the frames are in the file, built on first use
+		struct FrameLocation {
+			uint32 offset;
+			uint32 descId;
+		};
+		Common::Array<FrameLocation> _frameLocations;
+		void buildFrameLocations();
+
 		Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 		uint32 getCurFrameDuration();            // media time
 		uint32 findKeyFrame(uint32 frame) const;
@@ -33,6 +33,8 @@
 #include "common/system.h"
 #include "common/textconsole.h"
 
+#include "graphics/conversion.h"
+
 #include "audio/audiostream.h"
 #include "audio/mixer.h"
 #include "audio/decoders/raw.h"
@@ -46,6 +48,12 @@ enum SmkBlockTypes {
 	SMK_BLOCK_FILL = 3
 };
 
+// Number of bits looked up at once when decoding a Huffman code. Only
+// codes longer than this are walked bit by bit through the tree.
+enum {
+	kSmackerPrefixBits = 12
+};
+
 /*
  * class SmallHuffmanTree
  * A Huffman-tree to hold 8-bit values.
@@ -66,8 +74,8 @@ private:
 	uint16 _treeSize;
 	uint16 _tree[511];
 
-	uint16 _prefixtree[256];
-	byte _prefixlength[256];
+	uint16 _prefixtree[1 << kSmackerPrefixBits];
+	byte _prefixlength[1 << kSmackerPrefixBits];
 
 	Common::BitStreamMemory8LSB &_bs;
 	bool _empty;
@@ -80,8 +88,8 @@ SmallHuffmanTree::SmallHuffmanTree(Common::BitStreamMemory8LSB &bs)
 		return;
 	}
 
-	for (uint16 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
+	memset(_prefixtree, 0, sizeof(_prefixtree));
+	memset(_prefixlength, 0, sizeof(_prefixlength));
 
 	decodeTree(0, 0);
 
@@ -95,8 +103,8 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 	if (!_bs.getBit()) { // Leaf
 		_tree[_treeSize] = _bs.getBits(8);
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kSmackerPrefixBits) {
+			for (int i = 0; i < (1 << kSmackerPrefixBits); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -108,9 +116,9 @@ uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint16 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kSmackerPrefixBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kSmackerPrefixBits;
 	}
 
 	uint16 r1 = decodeTree(prefix, length + 1);
@@ -126,7 +134,7 @@ uint16 SmallHuffmanTree::getCode(Common::BitStreamMemory8LSB &bs) {
 	if (_empty)
 		return 0;
 
-	byte peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), 8));
+	uint32 peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), kSmackerPrefixBits));
 	uint16 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -162,8 +170,8 @@ private:
 	uint32 *_tree;
 	uint32  _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	uint32 _prefixtree[1 << kSmackerPrefixBits];
+	byte _prefixlength[1 << kSmackerPrefixBits];
 
 	/* Used during construction */
 	Common::BitStreamMemory8LSB &_bs;
@@ -174,6 +182,9 @@ private:
 
 BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize)
 	: _bs(bs) {
+	memset(_prefixtree, 0, sizeof(_prefixtree));
+	memset(_prefixlength, 0, sizeof(_prefixlength));
+
 	uint32 bit = _bs.getBit();
 	if (!bit) {
 		_tree = new uint32[1];
@@ -182,9 +193,6 @@ BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize)
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
 
@@ -229,8 +237,8 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		_tree[_treeSize] = v;
 
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
+		if (length <= kSmackerPrefixBits) {
+			for (int i = 0; i < (1 << kSmackerPrefixBits); i += (1 << length)) {
 				_prefixtree[prefix | i] = _treeSize;
 				_prefixlength[prefix | i] = length;
 			}
@@ -249,9 +257,9 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 	uint32 t = _treeSize++;
 
-	if (length == 8) {
+	if (length == kSmackerPrefixBits) {
 		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		_prefixlength[prefix] = kSmackerPrefixBits;
 	}
 
 	uint32 r1 = decodeTree(prefix, length + 1);
@@ -263,7 +271,7 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 }
 
 uint32 BigHuffmanTree::getCode(Common::BitStreamMemory8LSB &bs) {
-	byte peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), 8));
+	uint32 peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), kSmackerPrefixBits));
 	uint32 *p = &_tree[_prefixtree[peek]];
 	bs.skip(_prefixlength[peek]);
 
@@ -581,6 +589,9 @@ SmackerDecoder::SmackerVideoTrack::SmackerVideoTrack(uint32 width, uint32 height
 	_signature = signature;
 	_curFrame = -1;
 	_dirtyPalette = false;
+	_paletteMapDirty = true;
+	_lastDstPixels = 0;
+	_lastDstFrame = -1;
 	_MMapTree = _MClrTree = _FullTree = _TypeTree = 0;
 	memset(_palette, 0, 3 * 256);
 }
@@ -607,6 +618,79 @@ Graphics::PixelFormat SmackerDecoder::SmackerVideoTrack::getPixelFormat() const
 	return _surface->format;
 }
 
+namespace {
+
+template<typename PixelInt>
+void expandBlockRows(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint w, uint h, const uint32 *map) {
+	for (uint y = 0; y < h; y++) {
+		PixelInt *d = (PixelInt *)dst;
+
+		for (uint x = 0; x < w; x += 4) {
+			d[x + 0] = map[src[x + 0]];
+			d[x + 1] = map[src[x + 1]];
+			d[x + 2] = map[src[x + 2]];
+			d[x + 3] = map[src[x + 3]];
+		}
+
+		dst += dstPitch;
+		src += srcPitch;
+	}
+}
+
+} // End of anonymous namespace
+
+bool SmackerDecoder::SmackerVideoTrack::canDecodeNextFrameInto(const Graphics::Surface &dst) const {
+	return (dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4) && dst.w >= _surface->w && dst.h >= _surface->h;
+}
+
+bool SmackerDecoder::SmackerVideoTrack::decodeNextFrameInto(Graphics::Surface &dst, bool partial) {
+	const uint bytesPerPixel = dst.format.bytesPerPixel;
+
+	if (_paletteMapDirty || dst.format != _paletteMapFormat) {
+		Graphics::convertPaletteToMap(_paletteMap, _palette, 256, dst.format);
+		_paletteMapFormat = dst.format;
+		_paletteMapDirty = false;
+		_lastDstPixels = 0;
+	}
+
+	// When the surface still holds the previous frame, only the blocks
+	// changed by this one need to be written to it
+	const bool wholeFrame = !partial || _lastDstPixels != dst.getPixels() || _lastDstFrame < 0 || _lastDstFrame != _curFrame - 1;
+	_lastDstPixels = dst.getPixels();
+	_lastDstFrame = _curFrame;
+
+	if (wholeFrame)
+		return Graphics::crossBlitMap((byte *)dst.getPixels(), (const byte *)_surface->getPixels(), dst.pitch, _surface->pitch, _surface->w, _surface->h, bytesPerPixel, _paletteMap);
+
+	const uint blockHeight = (_flags & 6) ? 8 : 4;
+	const uint bw = _surface->w / 4;
+	const uint blocks = bw * (_surface->h / blockHeight);
+
+	for (uint block = 0; block < blocks; block++) {
+		if (!_dirtyBlocks.get(block))
+			continue;
+
+		// Write runs of changed blocks at once
+		uint end = block + 1;
+		while (end < blocks && end % bw != 0 && _dirtyBlocks.get(end))
+			end++;
+
+		const uint x = (block % bw) * 4;
+		const uint y = (block / bw) * blockHeight;
+		const byte *src = (const byte *)_surface->getBasePtr(x, y);
+		byte *out = (byte *)dst.getBasePtr(x, y);
+
+		if (bytesPerPixel == 2)
+			expandBlockRows<uint16>(out, src, dst.pitch, _surface->pitch, (end - block) * 4, blockHeight, _paletteMap);
+		else
+			expandBlockRows<uint32>(out, src, dst.pitch, _surface->pitch, (end - block) * 4, blockHeight, _paletteMap);
+
+		block = end - 1;
+	}
+
+	return true;
+}
+
 void SmackerDecoder::SmackerVideoTrack::readTrees(Common::BitStreamMemory8LSB &bs, uint32 mMapSize, uint32 mClrSize, uint32 fullSize, uint32 typeSize) {
 	_MMapTree = new BigHuffmanTree(bs, mMapSize);
 	_MClrTree = new BigHuffmanTree(bs, mClrSize);
@@ -813,6 +897,7 @@ void SmackerDecoder::SmackerVideoTrack::unpackPalette(Common::SeekableReadStream
 	free(chunk);
 
 	_dirtyPalette = true;
+	_paletteMapDirty = true;
 }
 
 SmackerDecoder::SmackerAudioTrack::SmackerAudioTrack(const AudioInfo &audioInfo, Audio::Mixer::SoundType soundType) :
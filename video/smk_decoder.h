@@ -87,7 +87,7 @@ protected:
 		~SmackerVideoTrack();
 
 		bool isRewindable() const { return true; }
-		bool rewind() { _curFrame = -1; return true; }
+		bool rewind() { _curFrame = -1; _lastDstFrame = -1; return true; }
 
 		uint16 getWidth() const;
 		uint16 getHeight() const;
@@ -95,6 +95,8 @@ protected:
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
 		const Graphics::Surface *decodeNextFrame() { return _surface; }
+		bool canDecodeNextFrameInto(const Graphics::Surface &dst) const;
+		bool decodeNextFrameInto(Graphics::Surface &dst, bool partial);
 		const byte *getPalette() const { _dirtyPalette = false; return _palette; }
 		bool hasDirtyPalette() const { return _dirtyPalette; }
 
@@ -117,6 +119,14 @@ protected:
 		byte _palette[3 * 256];
 		mutable bool _dirtyPalette;
 
+		// The palette in the format of the last surface passed to
+		// decodeNextFrameInto(), and the frame last written to it
+		uint32 _paletteMap[256];
+		Graphics::PixelFormat _paletteMapFormat;
+		bool _paletteMapDirty;
+		const void *_lastDstPixels;
+		int _lastDstFrame;
+
 		int _curFrame;
 		uint32 _frameCount;
 
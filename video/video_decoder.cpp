@@ -26,9 +26,12 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
 
+#include "graphics/conversion.h"
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
@@ -48,6 +51,9 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_partialFrameWrites = false;
+	_decodeAheadFrames = 0;
+	_shownDecodedFrame = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -56,10 +62,16 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	freeDecodedFrames();
+}
+
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	freeDecodedFrames();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -183,10 +195,34 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 	return Graphics::PixelFormat();
 }
 
+bool VideoDecoder::copyFrame(Graphics::Surface &dst, const Graphics::Surface &frame, const byte *palette) {
+	const uint width = MIN(dst.w, frame.w);
+	const uint height = MIN(dst.h, frame.h);
+
+	if (dst.format == frame.format) {
+		dst.copyRectToSurface(frame, 0, 0, Common::Rect(width, height));
+		return true;
+	}
+
+	if (frame.format.bytesPerPixel == 1) {
+		if (!palette)
+			return false;
+
+		uint32 map[256];
+		Graphics::convertPaletteToMap(map, palette, 256, dst.format);
+		return Graphics::crossBlitMap((byte *)dst.getPixels(), (const byte *)frame.getPixels(), dst.pitch, frame.pitch, width, height, dst.format.bytesPerPixel, map);
+	}
+
+	return Graphics::crossBlit((byte *)dst.getPixels(), (const byte *)frame.getPixels(), dst.pitch, frame.pitch, width, height, dst.format, frame.format);
+}
+
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (showDecodedFrame())
+		return _shownDecodedFrame->hasSurface ? _shownDecodedFrame->surface : 0;
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -207,11 +243,126 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	_needsUpdate = false;
+	_canSetDither = false;
+
+	if (showDecodedFrame())
+		return _shownDecodedFrame->hasSurface && copyFrame(dst, *_shownDecodedFrame->surface, _palette);
+
+	readNextPacket();
+
+	if (!_nextVideoTrack)
+		return false;
+
+	// Tracks may only report a palette change once, so the palette has
+	// to be read before a paletted frame is converted with it
+	const Graphics::Surface *frame = 0;
+	bool decoded = false;
+	if (_nextVideoTrack->canDecodeNextFrameInto(dst))
+		decoded = _nextVideoTrack->decodeNextFrameInto(dst, _partialFrameWrites);
+	else
+		frame = _nextVideoTrack->decodeNextFrame();
+
+	if (_nextVideoTrack->hasDirtyPalette()) {
+		_palette = _nextVideoTrack->getPalette();
+		_dirtyPalette = true;
+	}
+
+	if (frame)
+		decoded = copyFrame(dst, *frame, _palette);
+
+	findNextVideoTrack();
+
+	return decoded;
+}
+
+bool VideoDecoder::copyNextFrameInto(Graphics::Surface &dst) {
+	const Graphics::Surface *frame = decodeNextFrame();
+	return frame && copyFrame(dst, *frame, _palette);
+}
+
+void VideoDecoder::decodeAhead() {
+	int videoTrackCount = 0;
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			videoTrackCount++;
+
+	// The frame numbers and times of the decoded frames are those of a
+	// single track, which reversed playback moves in the other direction.
+	if (videoTrackCount != 1)
+		return;
+
+	while (_decodedFrames.size() < _decodeAheadFrames) {
+		VideoTrack *track = _nextVideoTrack;
+		if (!track || track->isReversed())
+			return;
+
+		if (_endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs())
+			return;
+
+		DecodedFrame *decoded;
+		if (_freeDecodedFrames.empty()) {
+			decoded = new DecodedFrame();
+			decoded->surface = new Graphics::Surface();
+		} else {
+			decoded = _freeDecodedFrames.back();
+			_freeDecodedFrames.pop_back();
+		}
+
+		_canSetDither = false;
+		readNextPacket();
+
+		decoded->curFrame = track->getCurFrame();
+		decoded->startTime = track->getNextFrameStartTime();
+
+		const Graphics::Surface *frame = track->decodeNextFrame();
+		decoded->hasSurface = frame != 0;
+		if (frame) {
+			Graphics::Surface *surface = decoded->surface;
+			if (surface->w != frame->w || surface->h != frame->h || surface->format != frame->format) {
+				surface->free();
+				surface->create(frame->w, frame->h, frame->format);
+			}
+
+			surface->copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+		}
+
+		decoded->dirtyPalette = track->hasDirtyPalette();
+		if (decoded->dirtyPalette)
+			memcpy(decoded->palette, track->getPalette(), sizeof(decoded->palette));
+
+		_decodedFrames.push_back(decoded);
+		findNextVideoTrack();
+	}
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// The video track is past the frames decoded ahead, so bring it back to
+	// the first of them before changing direction.
+	if (reverse && !_decodedFrames.empty()) {
+		if (!isSeekable())
+			return false;
+
+		Audio::Timestamp frameStartTime(_decodedFrames[0]->startTime, 1000);
+		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+			if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+				Audio::Timestamp frameTime = ((VideoTrack *)*it)->getFrameTime(_decodedFrames[0]->curFrame + 1);
+				if (frameTime >= 0)
+					frameStartTime = frameTime;
+			}
+		}
+
+		discardDecodedFrames();
+
+		if (!seekIntern(frameStartTime))
+			return false;
+	}
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -232,6 +383,10 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	// Frames decoded ahead are only counted once they are returned
+	if (!_decodedFrames.empty())
+		return _decodedFrames[0]->curFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -273,7 +428,21 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
+		return 0;
+
+	// Frames decoded ahead are always played forward
+	if (!_decodedFrames.empty()) {
+		uint32 currentTime = getTime();
+		uint32 nextFrameStartTime = _decodedFrames[0]->startTime;
+
+		if (nextFrameStartTime <= currentTime)
+			return 0;
+
+		return nextFrameStartTime - currentTime;
+	}
+
+	if (!_nextVideoTrack)
 		return 0;
 
 	uint32 currentTime = getTime();
@@ -295,6 +464,9 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	if (hasDecodedFrames())
+		return false;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
@@ -322,6 +494,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	discardDecodedFrames();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -356,6 +530,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	discardDecodedFrames();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -917,6 +1093,9 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	if (hasDecodedFrames())
+		return true;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
@@ -932,6 +1111,59 @@ bool VideoDecoder::hasFramesLeft() const {
 	return false;
 }
 
+bool VideoDecoder::showDecodedFrame() {
+	// The frame returned last time can be reused by decodeAhead() now
+	if (_shownDecodedFrame) {
+		_freeDecodedFrames.push_back(_shownDecodedFrame);
+		_shownDecodedFrame = 0;
+	}
+
+	if (_decodedFrames.empty())
+		return false;
+
+	_shownDecodedFrame = _decodedFrames.remove_at(0);
+
+	if (_shownDecodedFrame->dirtyPalette) {
+		memcpy(_decodedPalette, _shownDecodedFrame->palette, sizeof(_decodedPalette));
+		_palette = _decodedPalette;
+		_dirtyPalette = true;
+	}
+
+	return true;
+}
+
+bool VideoDecoder::hasDecodedFrames() const {
+	// Frames may have been decoded before an earlier end time was set
+	if (_decodedFrames.empty())
+		return false;
+
+	return !(isPlaying() && _endTimeSet && _decodedFrames[0]->startTime >= (uint)_endTime.msecs());
+}
+
+void VideoDecoder::discardDecodedFrames() {
+	for (uint i = 0; i < _decodedFrames.size(); i++)
+		_freeDecodedFrames.push_back(_decodedFrames[i]);
+
+	_decodedFrames.clear();
+}
+
+void VideoDecoder::freeDecodedFrames() {
+	discardDecodedFrames();
+
+	if (_shownDecodedFrame) {
+		_freeDecodedFrames.push_back(_shownDecodedFrame);
+		_shownDecodedFrame = 0;
+	}
+
+	for (uint i = 0; i < _freeDecodedFrames.size(); i++) {
+		_freeDecodedFrames[i]->surface->free();
+		delete _freeDecodedFrames[i]->surface;
+		delete _freeDecodedFrames[i];
+	}
+
+	_freeDecodedFrames.clear();
+}
+
 bool VideoDecoder::hasAudio() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeAudio)
@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +355,57 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode the next frame into a surface of the caller.
+	 *
+	 * This is meant for callers which would only copy the frame returned by
+	 * decodeNextFrame() to another surface, such as the one returned by
+	 * OSystem::lockScreen(). The frame is written to the top left corner of
+	 * the surface, converted to its format while it is written. Video tracks
+	 * able to do so write their output there directly, without a frame of
+	 * their own in between. Use Graphics::Surface::getSubArea() to write the
+	 * frame elsewhere in a surface.
+	 *
+	 * Paletted frames written to a surface that is not paletted are converted
+	 * with the palette of the video.
+	 *
+	 * A subclass overriding decodeNextFrame() to do more than returning the
+	 * frame of the video track must override this as well, and may fall back
+	 * to copyNextFrameInto() when it cannot write the frame directly.
+	 *
+	 * @param dst The surface to write the frame to
+	 * @return true if a frame was written, false otherwise, in which case the
+	 *         last frame should be kept on screen
+	 * @see setPartialFrameWrites()
+	 */
+	virtual bool decodeNextFrameInto(Graphics::Surface &dst);
+
+	/**
+	 * Allow decodeNextFrameInto() to only write the parts of a frame which
+	 * changed since the previous one, for the video tracks able to do so.
+	 *
+	 * This may only be enabled when the same surface is passed for
+	 * consecutive frames, and it is not drawn over in between. This is
+	 * not the case for the surface returned by OSystem::lockScreen(), so
+	 * this is disabled by default.
+	 *
+	 * @param enable true to only write the changed parts, false otherwise
+	 */
+	void setPartialFrameWrites(bool enable) { _partialFrameWrites = enable; }
+
+	/**
+	 * Copy a frame to the top left corner of a surface, converting it to
+	 * the format of the surface, as decodeNextFrameInto() does for video
+	 * tracks which cannot write their frames directly.
+	 *
+	 * @param dst The surface to copy the frame to
+	 * @param frame The frame, as returned by decodeNextFrame()
+	 * @param palette The palette of the video, for paletted frames
+	 * @return true if the frame was copied, false if it could not be
+	 *         converted to the format of the surface
+	 */
+	static bool copyFrame(Graphics::Surface &dst, const Graphics::Surface &frame, const byte *palette);
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -377,6 +428,30 @@ public:
 	 */
 	bool setReverse(bool reverse);
 
+	/**
+	 * Set how many frames decodeAhead() may decode before they are due.
+	 *
+	 * By default, this is 0 and no frames are decoded ahead.
+	 *
+	 * @param count The maximum number of frames decoded ahead
+	 */
+	void setDecodeAheadFrames(uint count) { _decodeAheadFrames = count; }
+
+	/**
+	 * Decode frames before they are due, up to the count set with
+	 * setDecodeAheadFrames().
+	 *
+	 * This is meant to be called while waiting for the next frame, so that
+	 * decodeNextFrame() only has to return a frame decoded earlier and a
+	 * frame slow to decode does not make the caller miss the time it is
+	 * due. Only videos with a single video track played forward are decoded
+	 * ahead.
+	 *
+	 * @note Decoders overriding decodeNextFrame() to do more work than
+	 * post-processing the returned frame do not support this.
+	 */
+	void decodeAhead();
+
 	/**
 	 * Tell the video to dither to a palette.
 	 *
@@ -603,6 +678,28 @@ protected:
 		 */
 		virtual const Graphics::Surface *decodeNextFrame() = 0;
 
+		/**
+		 * Return whether decodeNextFrameInto() can write the next frame
+		 * to a surface of the caller.
+		 *
+		 * By default, this returns false, and the VideoDecoder copies the
+		 * frame returned by decodeNextFrame() once it has read its palette.
+		 */
+		virtual bool canDecodeNextFrameInto(const Graphics::Surface &dst) const { return false; }
+
+		/**
+		 * Decode the next frame into a surface of the caller, converting
+		 * it to the format of that surface. This is only called when
+		 * canDecodeNextFrameInto() returned true for the surface.
+		 *
+		 * When partial is true, the surface holds the frame written to it
+		 * last, and only the parts which changed since then may be written.
+		 *
+		 * @see VideoDecoder::decodeNextFrameInto()
+		 * @see VideoDecoder::setPartialFrameWrites()
+		 */
+		virtual bool decodeNextFrameInto(Graphics::Surface &dst, bool partial) { return false; }
+
 		/**
 		 * Get the palette currently in use by this track
 		 */
@@ -887,6 +984,14 @@ protected:
 	 */
 	VideoTrack *findNextVideoTrack();
 
+	/**
+	 * Decode the next frame with decodeNextFrame() and copy it to a surface,
+	 * converting it to the format of the latter.
+	 *
+	 * @see decodeNextFrameInto()
+	 */
+	bool copyNextFrameInto(Graphics::Surface &dst);
+
 	/**
 	 * Typedef helpers for accessing tracks
 	 */
@@ -959,6 +1064,31 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Whether decodeNextFrameInto() may only write the changed parts
+	bool _partialFrameWrites;
+
+	// Frames decoded by decodeAhead(), with the state of the video track
+	// before decoding them
+	struct DecodedFrame {
+		Graphics::Surface *surface;
+		bool hasSurface;
+		int curFrame;
+		uint32 startTime;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	uint _decodeAheadFrames;
+	Common::Array<DecodedFrame *> _decodedFrames;
+	Common::Array<DecodedFrame *> _freeDecodedFrames;
+	DecodedFrame *_shownDecodedFrame;
+	byte _decodedPalette[256 * 3];
+
+	bool hasDecodedFrames() const;
+	bool showDecodedFrame();
+	void discardDecodedFrames();
+	void freeDecodedFrames();
+
 protected:
 	// Internal helper functions
 	void stopAudio();